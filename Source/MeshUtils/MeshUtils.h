@@ -128,6 +128,80 @@ inline void CopyWithIndices(T *dst, const T *src, const Indices& indices)
         dst[i] = src[indices[i]];
 }
 
+// weld identical values (bitwise comparison) with hash table.
+// dst_values receives unique values in order of appearance, dst_indices receives index to dst_values for each element of src.
+// returns number of unique values.
+template<class T, class Values, class Indices>
+inline size_t WeldValues(Values& dst_values, Indices& dst_indices, const T* src, size_t n)
+{
+    static_assert(sizeof(T) % sizeof(uint32_t) == 0, "T must consist of 32 bit words");
+    auto hash = [](const T& v) {
+        auto* w = (const uint32_t*)&v;
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < sizeof(T) / sizeof(uint32_t); ++i)
+            h = (h ^ w[i]) * 16777619u;
+        h ^= h >> 16;
+        return h;
+    };
+
+    size_t capacity = 16;
+    while (capacity < n * 2)
+        capacity <<= 1;
+    size_t mask = capacity - 1;
+
+    RawVector<int> table;
+    table.resize_discard(capacity);
+    std::fill(table.begin(), table.end(), -1);
+
+    dst_values.clear();
+    dst_indices.resize_discard(n);
+    const auto& values = dst_values;
+    for (size_t i = 0; i < n; ++i) {
+        const T& v = src[i];
+        size_t slot = hash(v) & mask;
+        for (;;) {
+            int vi = table[slot];
+            if (vi == -1) {
+                vi = (int)dst_values.size();
+                dst_values.push_back(v);
+                table[slot] = vi;
+            }
+            else if (std::memcmp(&values[vi], &v, sizeof(T)) != 0) {
+                slot = (slot + 1) & mask;
+                continue;
+            }
+            dst_indices[i] = vi;
+            break;
+        }
+    }
+    return dst_values.size();
+}
+
+// convert per-index values (src[i] for indices[i]) to per-vertex values.
+// fails if the values of indices that share a vertex are not identical (e.g. hard edges of normals).
+template<class T, class Values>
+inline bool ToPerVertex(Values& dst, const T* src, const int* indices, size_t num_indices, size_t num_vertices)
+{
+    RawVector<char> assigned;
+    assigned.resize_zeroclear(num_vertices);
+    dst.resize_zeroclear(num_vertices);
+    const auto& values = dst;
+
+    for (size_t i = 0; i < num_indices; ++i) {
+        int vi = indices[i];
+        if (vi < 0 || (size_t)vi >= num_vertices)
+            return false;
+        if (!assigned[vi]) {
+            assigned[vi] = 1;
+            dst[vi] = src[i];
+        }
+        else if (std::memcmp(&values[vi], &src[i], sizeof(T)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
 template<class Counts, class Offsets>
 inline void CountIndices(
     const Counts& counts, Offsets& offsets,
@@ -139,6 +139,17 @@ void MulVectors_Generic(const float4x4& m, const float3 src[], float3 dst[], siz
         dst[i] = mul_v(m, src[i]);
 }
 
+void ExtractTRS_Generic(const float4x4 src[], float3 dst_t[], quatf dst_r[], float3 dst_s[], size_t num)
+{
+    for (size_t i = 0; i < num; ++i)
+        extract_trs(src[i], dst_t[i], dst_r[i], dst_s[i]);
+}
+void ComposeTRS_Generic(const float3 t[], const quatf r[], const float3 s[], float4x4 dst[], size_t num)
+{
+    for (size_t i = 0; i < num; ++i)
+        dst[i] = transform(t[i], r[i], s[i]);
+}
+
 int RayTrianglesIntersectionIndexed_Generic(float3 pos, float3 dir, const float3 *vertices, const int *indices, int num_triangles, int& tindex, float& distance)
 {
     int num_hits = 0;
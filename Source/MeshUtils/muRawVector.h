@@ -684,6 +684,18 @@ public:
         }
     }
 
+    // hand over the buffer to the caller (must be freed by deallocate()) and become empty.
+    // returns nullptr if data is shared (not owned by this).
+    pointer release()
+    {
+        if (m_shared_data)
+            return nullptr;
+        pointer ret = m_data;
+        m_data = nullptr;
+        m_capacity = m_size = 0;
+        return ret;
+    }
+
     const RawVector<T, Align>& as_raw() const
     {
         return reinterpret_cast<const RawVector<T, Align>&>(*this);
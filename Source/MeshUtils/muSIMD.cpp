@@ -134,6 +134,19 @@ void MulVectors_ISPC(const float4x4& m, const float3 src[], float3 dst[], size_t
 }
 #endif
 
+#ifdef muSIMD_ExtractTRS
+void ExtractTRS_ISPC(const float4x4 src[], float3 dst_t[], quatf dst_r[], float3 dst_s[], size_t num)
+{
+    ispc::ExtractTRS((ispc::float4x4*)src, (ispc::float3*)dst_t, (ispc::quatf*)dst_r, (ispc::float3*)dst_s, (int)num);
+}
+#endif
+#ifdef muSIMD_ComposeTRS
+void ComposeTRS_ISPC(const float3 t[], const quatf r[], const float3 s[], float4x4 dst[], size_t num)
+{
+    ispc::ComposeTRS((ispc::float3*)t, (ispc::quatf*)r, (ispc::float3*)s, (ispc::float4x4*)dst, (int)num);
+}
+#endif
+
 
 #ifdef muSIMD_RayTrianglesIntersectionIndexed
 int RayTrianglesIntersectionIndexed_ISPC(
@@ -418,6 +431,19 @@ void MulVectors(const float4x4& m, const float3 src[], float3 dst[], size_t num_
 }
 #endif
 
+#if defined(muSIMD_ExtractTRS) || !defined(muEnableISPC)
+void ExtractTRS(const float4x4 src[], float3 dst_t[], quatf dst_r[], float3 dst_s[], size_t num)
+{
+    Forward(ExtractTRS, src, dst_t, dst_r, dst_s, num);
+}
+#endif
+#if defined(muSIMD_ComposeTRS) || !defined(muEnableISPC)
+void ComposeTRS(const float3 t[], const quatf r[], const float3 s[], float4x4 dst[], size_t num)
+{
+    Forward(ComposeTRS, t, r, s, dst, num);
+}
+#endif
+
 #if defined(muSIMD_RayTrianglesIntersectionIndexed) || !defined(muEnableISPC)
 int RayTrianglesIntersectionIndexed(float3 pos, float3 dir, const float3 *vertices, const int *indices, int num_triangles, int& tindex, float& result)
 {
@@ -53,6 +53,10 @@ bool NearEqual(const float4 *src1, const float4 *src2, size_t num, float eps = m
 void MulPoints(const float4x4& m, const float3 src[], float3 dst[], size_t num_data);
 void MulVectors(const float4x4& m, const float3 src[], float3 dst[], size_t num_data);
 
+// batch versions of extract_trs() and transform(t, r, s)
+void ExtractTRS(const float4x4 src[], float3 dst_t[], quatf dst_r[], float3 dst_s[], size_t num);
+void ComposeTRS(const float3 t[], const quatf r[], const float3 s[], float4x4 dst[], size_t num);
+
 int RayTrianglesIntersectionIndexed(float3 pos, float3 dir, const float3 *vertices, const int *indices, int num_triangles, int& tindex, float& distance);
 int RayTrianglesIntersectionFlattened(float3 pos, float3 dir, const float3 *vertices, int num_triangles, int& tindex, float& distance);
 int RayTrianglesIntersectionSoA(float3 pos, float3 dir,
@@ -186,6 +190,11 @@ void MulPoints_ISPC(const float4x4& m, const float3 src[], float3 dst[], size_t
 void MulVectors_Generic(const float4x4& m, const float3 src[], float3 dst[], size_t num_data);
 void MulVectors_ISPC(const float4x4& m, const float3 src[], float3 dst[], size_t num_data);
 
+void ExtractTRS_Generic(const float4x4 src[], float3 dst_t[], quatf dst_r[], float3 dst_s[], size_t num);
+void ExtractTRS_ISPC(const float4x4 src[], float3 dst_t[], quatf dst_r[], float3 dst_s[], size_t num);
+void ComposeTRS_Generic(const float3 t[], const quatf r[], const float3 s[], float4x4 dst[], size_t num);
+void ComposeTRS_ISPC(const float3 t[], const quatf r[], const float3 s[], float4x4 dst[], size_t num);
+
 int RayTrianglesIntersectionIndexed_Generic(float3 pos, float3 dir, const float3 *vertices, const int *indices, int num_triangles, int& tindex, float& distance);
 int RayTrianglesIntersectionIndexed_ISPC(float3 pos, float3 dir, const float3 *vertices, const int *indices, int num_triangles, int& tindex, float& distance);
 int RayTrianglesIntersectionFlattened_Generic(float3 pos, float3 dir, const float3 *vertices, int num_triangles, int& tindex, float& distance);
@@ -17,6 +17,9 @@
 #define muSIMD_MulVectors3
 #define muSIMD_MulPoints3
 
+#define muSIMD_ExtractTRS
+#define muSIMD_ComposeTRS
+
 //#define muSIMD_RayTrianglesIntersectionIndexed
 //#define muSIMD_RayTrianglesIntersectionFlattened
 //#define muSIMD_RayTrianglesIntersectionSoA
@@ -1,5 +1,11 @@
 #include "pch.h"
 #include "muStream.h"
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
 
 namespace mu {
 
@@ -98,6 +104,221 @@ char* MemoryStream::gskip(size_t n)
 }
 
 
+MemoryMappedFile::MemoryMappedFile()
+{
+}
+
+MemoryMappedFile::MemoryMappedFile(const char* path)
+{
+    open(path);
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MemoryMappedFile::open(const char* path)
+{
+    close();
+
+    HANDLE file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        ::CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (!mapping) {
+        ::CloseHandle(file);
+        return false;
+    }
+
+    void* data = ::MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!data) {
+        ::CloseHandle(mapping);
+        ::CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = (char*)data;
+    m_size = (size_t)size.QuadPart;
+    return true;
+}
+
+void MemoryMappedFile::close()
+{
+    if (m_data) {
+        ::UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if (m_mapping) {
+        ::CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file) {
+        ::CloseHandle(m_file);
+        m_file = nullptr;
+    }
+    m_size = 0;
+}
+
+#else
+
+bool MemoryMappedFile::open(const char* path)
+{
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    void* data = ::mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data = (char*)data;
+    m_size = (size_t)st.st_size;
+    return true;
+}
+
+void MemoryMappedFile::close()
+{
+    if (m_data) {
+        ::munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+    m_size = 0;
+}
+
+#endif
+
+bool MemoryMappedFile::valid() const { return m_data != nullptr; }
+char* MemoryMappedFile::data() const { return m_data; }
+size_t MemoryMappedFile::size() const { return m_size; }
+
+
+MappedStreamBuf::MappedStreamBuf()
+{
+}
+
+void MappedStreamBuf::reset(char* data, size_t size)
+{
+    this->setg(data, data, data + size);
+}
+
+std::ios::pos_type MappedStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode /*mode*/)
+{
+    char* p = this->eback();
+    char* e = this->egptr();
+    char* g = nullptr;
+    if (dir == std::ios::beg)
+        g = p + off;
+    else if (dir == std::ios::cur)
+        g = this->gptr() + off;
+    else
+        g = e + off;
+
+    if (g < p || g > e)
+        return pos_type(off_type(-1));
+    this->setg(p, g, e);
+    return pos_type(off_type(g - p));
+}
+
+std::ios::pos_type MappedStreamBuf::seekpos(pos_type pos, std::ios_base::openmode mode)
+{
+    return seekoff(off_type(pos), std::ios::beg, mode);
+}
+
+int MappedStreamBuf::underflow()
+{
+    return traits_type::eof();
+}
+
+char* MappedStreamBuf::gskip(size_t n)
+{
+    auto ret = this->gptr();
+    if (n > size_t(this->egptr() - ret))
+        return nullptr;
+    this->setg(this->eback(), ret + n, this->egptr());
+    return ret;
+}
+
+MappedStream::MappedStream()
+    : std::istream(&m_buf)
+{
+}
+
+MappedStream::MappedStream(const char* path)
+    : std::istream(&m_buf)
+{
+    open(path);
+}
+
+MappedStream::MappedStream(const MemoryMappedFilePtr& file)
+    : std::istream(&m_buf)
+{
+    open(file);
+}
+
+bool MappedStream::open(const char* path)
+{
+    auto file = std::make_shared<MemoryMappedFile>();
+    file->open(path);
+    return open(file);
+}
+
+bool MappedStream::open(const MemoryMappedFilePtr& file)
+{
+    close();
+
+    if (!file || !file->valid()) {
+        this->setstate(std::ios::failbit);
+        return false;
+    }
+    m_file = file;
+    m_buf.reset(m_file->data(), m_file->size());
+    return true;
+}
+
+void MappedStream::close()
+{
+    // release only our reference. objects that share mapped memory may still hold the file.
+    m_file.reset();
+    m_buf.reset(nullptr, 0);
+    this->clear();
+}
+
+const MemoryMappedFilePtr& MappedStream::getFile() const
+{
+    return m_file;
+}
+
+char* MappedStream::gskip(size_t n)
+{
+    char* ret = m_buf.gskip(n);
+    if (!ret)
+        this->setstate(std::ios::eofbit | std::ios::failbit);
+    return ret;
+}
+
+
 static RawVector<char> s_dummy_buf;
 
 CounterStreamBuf::CounterStreamBuf()
@@ -1,5 +1,6 @@
 #pragma once
 #include <iostream>
+#include <memory>
 #include "muRawVector.h"
 
 namespace mu {
@@ -44,6 +45,68 @@ private:
 };
 
 
+// memory mapped file (read only. pages are mapped copy-on-write, so writing to them never touches the file)
+class MemoryMappedFile
+{
+public:
+    MemoryMappedFile();
+    MemoryMappedFile(const char* path);
+    ~MemoryMappedFile();
+    bool open(const char* path);
+    void close();
+
+    bool valid() const;
+    char* data() const;
+    size_t size() const;
+
+private:
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+using MemoryMappedFilePtr = std::shared_ptr<MemoryMappedFile>;
+
+class MappedStreamBuf : public std::streambuf
+{
+public:
+    MappedStreamBuf();
+    void reset(char* data, size_t size);
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode mode) override;
+    int underflow() override;
+
+    char* gskip(size_t n);
+};
+
+// input stream that reads from memory mapped file.
+// sg::deserializer recognizes this and SharedVector directly references mapped memory.
+// getFile() must be kept alive while deserialized objects are in use.
+class MappedStream : public std::istream
+{
+public:
+    MappedStream();
+    MappedStream(const char* path);
+    MappedStream(const MemoryMappedFilePtr& file);
+    bool open(const char* path);
+    bool open(const MemoryMappedFilePtr& file);
+    void close();
+
+    const MemoryMappedFilePtr& getFile() const;
+    char* gskip(size_t n); // return current read pointer and advance n byte
+
+private:
+    MemoryMappedFilePtr m_file;
+    MappedStreamBuf m_buf;
+};
+
+
 // counter stream
 class CounterStreamBuf : public std::streambuf
 {
@@ -32,6 +32,9 @@ DocumentExporter::~DocumentExporter()
 bool DocumentExporter::initialize(MQDocument /*doc*/)
 {
     m_scene->up_axis = UpAxis::Y;
+    m_scene->write_options = *m_options;
+    // the merged mesh is rebuilt by flush() every frame. its buffers can be handed over to the writer instead of copied.
+    m_scene->write_options.release_mesh_buffers = m_options->merge_meshes;
     return true;
 }
 
@@ -119,11 +122,22 @@ bool DocumentExporter::write(MQDocument doc, bool one_shot)
     if (!m_root) {
         m_root = m_scene->root_node;
 #if MQPLUGIN_VERSION >= 0x0470
-        if (m_options->export_skeletons && m_bone_manager->GetBoneNum() != 0) {
+        bool has_bones = m_options->export_skeletons && m_bone_manager->GetBoneNum() != 0;
+
+        // blendshape weights are animated through a skeleton. without bones it has no joints.
+        bool has_morphs = false;
+        if (m_options->export_blendshapes && !m_options->merge_meshes) {
+            std::vector<MQObject> bs_bases;
+            m_morph_manager->EnumBaseObjects(bs_bases);
+            has_morphs = !bs_bases.empty();
+        }
+
+        if (has_bones || has_morphs) {
             auto skel_root = m_scene->createNode<SkelRootNode>(m_root, "Model");
             skel_root->skeleton= m_scene->createNode<SkeletonNode>(skel_root, "Skel");
             m_root = skel_root;
-            m_skeleton = skel_root->skeleton;
+            if (has_bones)
+                m_skeleton = skel_root->skeleton;
         }
 #endif
         if (m_options->merge_meshes) {
@@ -265,6 +279,21 @@ bool DocumentExporter::write(MQDocument doc, bool one_shot)
             rec.mesh->toLocalSpace();
     });
 
+    // count before flush. flush() converts meshes on its own task.
+    int total_vertices = 0;
+    int total_faces = 0;
+    for (auto& rec : m_obj_records) {
+        if (rec.mesh) {
+            total_vertices += (int)rec.mesh->points.size();
+            total_faces += (int)rec.mesh->counts.size();
+        }
+    }
+
+    // the previous flush is complete here. results of it must be copied before the next flush starts.
+    float write_time = m_write_time;
+    int checkpoint_count = m_checkpoint_count;
+    float checkpoint_time = m_checkpoint_time;
+
     // flush async
     m_task_write = std::async(std::launch::async, [this]() { flush(); });
     m_last_write = t;
@@ -275,17 +304,25 @@ bool DocumentExporter::write(MQDocument doc, bool one_shot)
 #endif
 
     // log
-    int total_vertices = 0;
-    int total_faces = 0;
-    for (auto& rec : m_obj_records) {
-        if (rec.mesh) {
-            total_vertices += (int)rec.mesh->points.size();
-            total_faces += (int)rec.mesh->counts.size();
-        }
-    }
-
     if (m_options->log_info) {
-        m_options->log_info(mu::Format("frame %d: %d vertices, %d faces", m_frame - 1, total_vertices, total_faces));
+        // write of this frame is still in progress. report the previous one.
+        auto stats = m_scene->getWriteStats();
+
+        std::string checkpoint;
+        if (checkpoint_count > 0)
+            checkpoint = mu::Format(", checkpoint %d completed in %.2fms", checkpoint_count, checkpoint_time);
+
+        if (stats.frames_written > 0 && m_options->max_queued_frames > 0) {
+            // the writer has its own thread. write_time is the time to queue the frame.
+            m_options->log_info(mu::Format("frame %d: %d vertices, %d faces (%d frames written, last one in %.2fms, queue %d/%d, stalled %d times %.2fms)%s",
+                m_frame - 1, total_vertices, total_faces, stats.frames_written, stats.last_write_time,
+                stats.queue_depth, m_options->max_queued_frames, stats.stall_count, stats.stall_time, checkpoint.c_str()));
+        }
+        else if (m_frame > 1)
+            m_options->log_info(mu::Format("frame %d: %d vertices, %d faces (frame %d written in %.2fms)%s",
+                m_frame - 1, total_vertices, total_faces, m_frame - 2, write_time, checkpoint.c_str()));
+        else
+            m_options->log_info(mu::Format("frame %d: %d vertices, %d faces", m_frame - 1, total_vertices, total_faces));
     }
     return true;
 }
@@ -591,7 +628,25 @@ void DocumentExporter::flush()
     });
 
     // do write
+    mu::ScopedTimer timer;
     m_scene->write(m_time);
+    m_write_time = timer.elapsed();
+
+    // checkpoint. this is on the flush task and capture continues meanwhile.
+    if (m_options->checkpoint_interval > 0.0 && !m_one_shot) {
+        auto now = mu::Now();
+        if (m_last_checkpoint == 0) {
+            m_last_checkpoint = now;
+        }
+        else if (mu::NS2Sd(now - m_last_checkpoint) >= m_options->checkpoint_interval) {
+            mu::ScopedTimer checkpoint_timer;
+            if (m_scene->checkpoint()) {
+                m_checkpoint_time = checkpoint_timer.elapsed();
+                ++m_checkpoint_count;
+            }
+            m_last_checkpoint = now;
+        }
+    }
 }
 
 void DocumentExporter::waitFlush()
@@ -3,7 +3,7 @@
 
 namespace mqusd {
 
-struct ExportOptions : public ConvertOptions
+struct ExportOptions : public ConvertOptions, public WriteOptions
 {
     bool export_uvs = true;
     bool export_normals = true;
@@ -22,6 +22,7 @@ struct ExportOptions : public ConvertOptions
     float frame_rate = 30.0f; // relevant only when keep_time is false
     float time_scale = 1.0f; // relevant only when keep_time is true
     double capture_interval = 5.0; // in seconds
+    double checkpoint_interval = 0.0; // in seconds. if > 0, samples written so far are flushed to the file periodically while recording
 
     std::function<void(const char*)> log_info;
 
@@ -89,6 +90,10 @@ private:
     mu::nanosec m_last_write = 0;
     int m_frame = 0;
     double m_time = 0.0;
+    float m_write_time = 0.0f; // time spent in Scene::write() of the last flush in ms
+    mu::nanosec m_last_checkpoint = 0;
+    int m_checkpoint_count = 0;
+    float m_checkpoint_time = 0.0f; // time spent in Scene::checkpoint() of the last checkpoint in ms
     std::vector<ObjectRecord> m_obj_records;
     std::map<UINT, MaterialRecord> m_material_records;
     std::vector<MaterialNode*> m_material_nodes;
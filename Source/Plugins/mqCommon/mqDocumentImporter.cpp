@@ -129,21 +129,33 @@ bool DocumentImporter::deleteMQObject(MQDocument doc, UINT id)
     return false;
 }
 
+// nodes in prototypes of instances are not objects by themselves. they are reached only through InstancerNode::protos.
+template<class NodeT>
+static std::vector<NodeT*> GetImportNodes(Scene& scene)
+{
+    std::vector<NodeT*> ret;
+    scene.eachNode<NodeT>([&ret](NodeT* n) {
+        if (!n->prototype)
+            ret.push_back(n);
+    });
+    return ret;
+}
+
 bool DocumentImporter::setup()
 {
-    m_mesh_nodes = m_scene->getNodes<MeshNode>();
+    m_mesh_nodes = GetImportNodes<MeshNode>(*m_scene);
     transform_container(m_obj_records, m_mesh_nodes, [](auto& rec, MeshNode* node) {
         rec.node = node;
         rec.node->userdata = &rec;
         rec.blendshape_ids.resize(rec.node->blendshapes.size());
     });
 
-    transform_container(m_inst_records, m_scene->getNodes<InstancerNode>(), [](auto& rec, InstancerNode* node) {
+    transform_container(m_inst_records, GetImportNodes<InstancerNode>(*m_scene), [](auto& rec, InstancerNode* node) {
         rec.node = node;
         rec.node->userdata = &rec;
     });
     
-    transform_container(m_skel_records, m_scene->getNodes<SkeletonNode>(), [](auto& rec, SkeletonNode* node) {
+    transform_container(m_skel_records, GetImportNodes<SkeletonNode>(*m_scene), [](auto& rec, SkeletonNode* node) {
         rec.node = node;
         rec.node->userdata = &rec;
 
@@ -192,12 +204,17 @@ bool DocumentImporter::read(MQDocument doc, double t)
 
 
     // read scene
+    // nodes not updated by read() keep converted data of the previous read. they need to be re-read if
+    // options are changed, or if merging meshes (merged mesh is rebuilt from all nodes and that modifies them).
+    if (m_option_changed || m_options->merge_meshes)
+        m_scene->invalidate();
     m_scene->read(t);
     setup();
 
     // convert
     mu::parallel_for_each(m_scene->nodes.begin(), m_scene->nodes.end(), [this](NodePtr& n) {
-        n->convert(*m_options);
+        if (n->updated)
+            n->convert(*m_options);
     });
 
     // materials
@@ -205,7 +222,8 @@ bool DocumentImporter::read(MQDocument doc, double t)
         updateMaterials(doc);
 
     mu::parallel_for_each(m_mesh_nodes.begin(), m_mesh_nodes.end(), [this](MeshNode* n) {
-        n->buildMaterialIDs();
+        if (n->updated)
+            n->buildMaterialIDs();
     });
 
     // reserve materials
@@ -334,6 +352,10 @@ bool DocumentImporter::read(MQDocument doc, double t)
         };
 
         for (auto& rec : m_obj_records) {
+            // untouched mesh is already in the document
+            if (!rec.node->updated && rec.mqid != 0)
+                continue;
+
             auto obj = handle_mqobject(rec);
             if (m_options->bake_meshes) {
                 rec.tmp_mesh.clear();
@@ -348,7 +370,8 @@ bool DocumentImporter::read(MQDocument doc, double t)
                 // blendshapes
                 if (m_options->import_blendshapes)
                     handle_blendshape(rec, obj);
-                rec.prev_indices = rec.node->indices;
+                if (rec.node->topology_updated || m_option_changed)
+                    rec.prev_indices = rec.node->indices;
             }
         }
 
@@ -392,7 +415,13 @@ bool DocumentImporter::updateMesh(MQDocument /*doc*/, MQObject obj, const MeshNo
     int npoints = (int)src.points.size();
     int nfaces = (int)src.counts.size();
 
-    if (obj->GetVertexCount() != npoints || obj->GetFaceCount() != nfaces || src.indices.as_raw() != prev_indices) {
+    // if the reader kept the topology of the previous read, comparing indices can be skipped.
+    // options may change indices (e.g. flip_faces) even in that case.
+    bool topology_changed = obj->GetVertexCount() != npoints || obj->GetFaceCount() != nfaces;
+    if (!topology_changed && (src.topology_updated || m_option_changed))
+        topology_changed = src.indices.as_raw() != prev_indices;
+
+    if (topology_changed) {
         // topology changed. re-create mesh.
         obj->Clear();
 
@@ -3,7 +3,7 @@
 
 namespace mqusd {
 
-struct ImportOptions : public ConvertOptions
+struct ImportOptions : public ConvertOptions, public OpenOptions
 {
     bool import_visibility = true;
     bool import_transform = true;
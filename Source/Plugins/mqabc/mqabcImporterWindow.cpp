@@ -65,6 +65,17 @@ mqabcImporterWindow::mqabcImporterWindow(MQBasePlugin* plugin)
         m_check_merge_only_visible = CreateCheckBox(hf, L"Only Visible");
         m_check_merge_only_visible->AddChangedEvent(this, &mqabcImporterWindow::OnSettingsUpdate);
     }
+    {
+        MQGroupBox* group = CreateGroupBox(vf, L"Sample Cache");
+        MQFrame* hf = CreateHorizontalFrame(group);
+        CreateLabel(hf, L"Memory Budget (MB)");
+        m_edit_cache_size = CreateEdit(hf);
+        m_edit_cache_size->SetNumeric(MQEdit::NUMERIC_INT);
+        m_edit_cache_size->AddChangedEvent(this, &mqabcImporterWindow::OnSettingsUpdate);
+
+        // budget is applied when a file is opened
+        m_label_cache_stats = CreateLabel(group, L"");
+    }
     {
         m_button_ok = CreateButton(vf, L"OK");
         m_button_ok->AddClickEvent(this, &mqabcImporterWindow::OnOKClicked);
@@ -129,6 +140,11 @@ BOOL mqabcImporterWindow::OnSettingsUpdate(MQWidgetBase* sender, MQDocument doc)
     opt.merge_meshes = m_check_merge->GetChecked();
     opt.merge_only_visible = m_check_merge_only_visible->GetChecked();
 
+    {
+        auto str = mu::ToMBS(m_edit_cache_size->GetText());
+        opt.sample_cache_size = std::max(std::atoi(str.c_str()), 0);
+    }
+
     Refresh(doc);
     return 0;
 }
@@ -155,6 +171,11 @@ void mqabcImporterWindow::SyncSettings()
 
     m_check_merge->SetChecked(opt.merge_meshes);
     m_check_merge_only_visible->SetChecked(opt.merge_only_visible);
+
+    swprintf(buf, buf_len, L"%d", opt.sample_cache_size);
+    m_edit_cache_size->SetText(buf);
+
+    UpdateCacheStats();
 }
 
 bool mqabcImporterWindow::Open(MQDocument doc, const std::string& path)
@@ -167,6 +188,7 @@ bool mqabcImporterWindow::Open(MQDocument doc, const std::string& path)
         return false;
     }
 
+    m_scene->open_options = m_options;
     if (!m_scene->open(path.c_str())) {
         m_scene = {};
 
@@ -176,6 +198,7 @@ bool mqabcImporterWindow::Open(MQDocument doc, const std::string& path)
 
     m_importer.reset(new DocumentImporter(m_plugin, m_scene.get(), &m_options));
     m_importer->read(doc, m_scene->time_start);
+    UpdateCacheStats();
 
     if (m_scene->frame_count > 0) {
         m_slider_frame->SetMin(1.0);
@@ -194,6 +217,7 @@ bool mqabcImporterWindow::Close()
     m_importer = {};
     m_scene = {};
     m_last_frame = 0;
+    UpdateCacheStats();
     return true;
 }
 
@@ -204,6 +228,7 @@ void mqabcImporterWindow::Seek(MQDocument doc, int frame)
 
     m_last_frame = frame;
     m_importer->read(doc, m_scene->frameToTime(frame - 1));
+    UpdateCacheStats();
 
     // repaint
     MQ_RefreshView(nullptr);
@@ -214,6 +239,25 @@ void mqabcImporterWindow::Refresh(MQDocument doc)
     Seek(doc, m_last_frame);
 }
 
+void mqabcImporterWindow::UpdateCacheStats()
+{
+    if (!m_scene) {
+        m_label_cache_stats->SetText(L"");
+        return;
+    }
+    if (m_scene->open_options.sample_cache_size <= 0) {
+        m_label_cache_stats->SetText(L"Disabled");
+        return;
+    }
+
+    const size_t buf_len = 256;
+    wchar_t buf[buf_len];
+    auto stats = m_scene->getReadStats();
+    swprintf(buf, buf_len, L"%.1f MB used, %d hits, %d misses, %d evictions",
+        double(stats.cache_size) / (1024.0 * 1024.0), stats.cache_hits, stats.cache_misses, stats.cache_evictions);
+    m_label_cache_stats->SetText(buf);
+}
+
 bool mqabcImporterWindow::IsOpened() const
 {
     return m_scene != nullptr;
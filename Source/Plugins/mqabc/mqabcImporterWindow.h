@@ -22,6 +22,7 @@ public:
     bool Close();
     void Seek(MQDocument doc, int frame);
     void Refresh(MQDocument doc);
+    void UpdateCacheStats();
     bool IsOpened() const;
 
 private:
@@ -39,6 +40,9 @@ private:
     MQCheckBox* m_check_merge = nullptr;
     MQCheckBox* m_check_merge_only_visible = nullptr;
 
+    MQEdit* m_edit_cache_size = nullptr;
+    MQLabel* m_label_cache_stats = nullptr;
+
     MQButton* m_button_ok = nullptr;
 
 
@@ -92,6 +92,14 @@ mqabcRecorderWindow::mqabcRecorderWindow(MQBasePlugin* plugin)
             m_edit_interval->SetNumeric(MQEdit::NUMERIC_DOUBLE);
             m_edit_interval->AddChangedEvent(this, &mqabcRecorderWindow::OnSettingsUpdate);
         }
+        {
+            MQFrame* hf = CreateHorizontalFrame(vf);
+            CreateLabel(hf, L"Max Queued Frames");
+
+            m_edit_queue = CreateEdit(hf);
+            m_edit_queue->SetNumeric(MQEdit::NUMERIC_INT);
+            m_edit_queue->AddChangedEvent(this, &mqabcRecorderWindow::OnSettingsUpdate);
+        }
 
         m_button_recording = CreateButton(vf, L"Start Recording");
         m_button_recording->AddClickEvent(this, &mqabcRecorderWindow::OnRecordingClicked);
@@ -137,6 +145,10 @@ BOOL mqabcRecorderWindow::OnSettingsUpdate(MQWidgetBase* sender, MQDocument doc)
         auto value = std::atof(str.c_str());
         opt.capture_interval = value;
     }
+    {
+        auto str = mu::ToMBS(m_edit_queue->GetText());
+        opt.max_queued_frames = std::max(std::atoi(str.c_str()), 0);
+    }
     opt.freeze_mirror = m_check_mirror->GetChecked();
     opt.freeze_lathe = m_check_lathe->GetChecked();
     opt.freeze_subdiv = m_check_subdiv->GetChecked();
@@ -204,6 +216,9 @@ void mqabcRecorderWindow::SyncSettings()
     swprintf(buf, buf_len, L"%.2lf", opt.capture_interval);
     m_edit_interval->SetText(buf);
 
+    swprintf(buf, buf_len, L"%d", opt.max_queued_frames);
+    m_edit_queue->SetText(buf);
+
     swprintf(buf, buf_len, L"%.3f", opt.scale_factor);
     m_edit_scale->SetText(buf);
 
@@ -30,6 +30,7 @@ private:
 
     MQFrame* m_frame_settings = nullptr;
     MQEdit* m_edit_interval = nullptr;
+    MQEdit* m_edit_queue = nullptr;
     MQEdit* m_edit_scale = nullptr;
 
     MQCheckBox* m_check_normals = nullptr;
@@ -37,6 +37,9 @@ mqusdExporterWindow::mqusdExporterWindow(MQBasePlugin* plugin)
 
         m_check_skeletons = CreateCheckBox(group, L"Export Bones");
         m_check_skeletons->AddChangedEvent(this, &mqusdExporterWindow::OnSettingsUpdate);
+
+        m_check_indexed = CreateCheckBox(group, L"Indexed Primvars");
+        m_check_indexed->AddChangedEvent(this, &mqusdExporterWindow::OnSettingsUpdate);
     }
     {
         MQGroupBox* group = CreateGroupBox(vf, L"Freeze");
@@ -107,6 +110,7 @@ BOOL mqusdExporterWindow::OnSettingsUpdate(MQWidgetBase* sender, MQDocument doc)
     }
     opt.export_blendshapes = m_check_blendshapes->GetChecked();
     opt.export_skeletons = m_check_skeletons->GetChecked();
+    opt.indexed_primvars = m_check_indexed->GetChecked();
 
     opt.freeze_mirror = m_check_mirror->GetChecked();
     opt.freeze_lathe = m_check_lathe->GetChecked();
@@ -143,6 +147,7 @@ void mqusdExporterWindow::SyncSettings()
 
     m_check_blendshapes->SetChecked(opt.export_blendshapes);
     m_check_skeletons->SetChecked(opt.export_skeletons);
+    m_check_indexed->SetChecked(opt.indexed_primvars);
 
     m_check_mirror->SetChecked(opt.freeze_mirror);
     m_check_lathe->SetChecked(opt.freeze_lathe);
@@ -30,6 +30,7 @@ private:
 
     MQCheckBox* m_check_blendshapes = nullptr;
     MQCheckBox* m_check_skeletons = nullptr;
+    MQCheckBox* m_check_indexed = nullptr;
 
     MQCheckBox* m_check_flip_v = nullptr;
     MQCheckBox* m_check_flip_x = nullptr;
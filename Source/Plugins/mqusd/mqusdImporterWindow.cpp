@@ -85,6 +85,23 @@ mqusdImporterWindow::mqusdImporterWindow(MQBasePlugin* plugin)
         m_check_merge_only_visible = CreateCheckBox(hf, L"Only Visible");
         m_check_merge_only_visible->AddChangedEvent(this, &mqusdImporterWindow::OnSettingsUpdate);
     }
+    {
+        MQGroupBox* group = CreateGroupBox(vf, L"Stage (applied on open)");
+
+        MQFrame* hf = CreateHorizontalFrame(group);
+        CreateLabel(hf, L"Population Mask");
+        m_edit_mask = CreateEdit(hf);
+        m_edit_mask->AddChangedEvent(this, &mqusdImporterWindow::OnSettingsUpdate);
+
+        m_check_payloads = CreateCheckBox(group, L"Load Payloads");
+        m_check_payloads->AddChangedEvent(this, &mqusdImporterWindow::OnSettingsUpdate);
+
+        hf = CreateHorizontalFrame(group);
+        CreateLabel(hf, L"Path");
+        m_edit_load_path = CreateEdit(hf);
+        m_button_load = CreateButton(hf, L"Load");
+        m_button_load->AddClickEvent(this, &mqusdImporterWindow::OnLoadClicked);
+    }
     {
         m_button_ok = CreateButton(vf, L"OK");
         m_button_ok->AddClickEvent(this, &mqusdImporterWindow::OnOKClicked);
@@ -156,10 +173,40 @@ BOOL mqusdImporterWindow::OnSettingsUpdate(MQWidgetBase* sender, MQDocument doc)
     opt.merge_meshes = m_check_merge->GetChecked();
     opt.merge_only_visible = m_check_merge_only_visible->GetChecked();
 
+    {
+        // paths separated by ';'
+        auto str = mu::ToMBS(m_edit_mask->GetText());
+        opt.population_mask.clear();
+        size_t pos = 0;
+        while (pos <= str.size()) {
+            size_t end = std::min(str.find(';', pos), str.size());
+            auto path = str.substr(pos, end - pos);
+            path.erase(0, path.find_first_not_of(' '));
+            path.erase(path.find_last_not_of(' ') + 1);
+            if (!path.empty())
+                opt.population_mask.push_back(path);
+            pos = end + 1;
+        }
+    }
+    opt.load_payloads = m_check_payloads->GetChecked();
+
     Refresh(doc);
     return 0;
 }
 
+BOOL mqusdImporterWindow::OnLoadClicked(MQWidgetBase* sender, MQDocument doc)
+{
+    if (!m_scene)
+        return 0;
+
+    auto path = mu::ToMBS(m_edit_load_path->GetText());
+    if (m_scene->load(path.c_str()))
+        Refresh(doc);
+    else
+        MQShowError("Failed to load the path.\nPossible reason: the path doesn't exist or is outside of the population mask.");
+    return 0;
+}
+
 BOOL mqusdImporterWindow::OnOKClicked(MQWidgetBase* sender, MQDocument doc)
 {
     SetVisible(false);
@@ -200,6 +247,17 @@ void mqusdImporterWindow::SyncSettings()
     m_check_merge->SetChecked(opt.merge_meshes);
     m_check_merge_only_visible->SetChecked(opt.merge_only_visible);
 
+    {
+        std::string mask;
+        for (auto& path : opt.population_mask) {
+            if (!mask.empty())
+                mask += ";";
+            mask += path;
+        }
+        m_edit_mask->SetText(mu::ToWCS(mask));
+    }
+    m_check_payloads->SetChecked(opt.load_payloads);
+
     UpdateRelations();
 }
 
@@ -213,6 +271,7 @@ bool mqusdImporterWindow::Open(MQDocument doc, const std::string& path)
         return false;
     }
 
+    m_scene->open_options = m_options;
     if (!m_scene->open(path.c_str())) {
         m_scene = {};
 
@@ -15,6 +15,7 @@ public:
     BOOL OnSampleEdit(MQWidgetBase* sender, MQDocument doc);
     BOOL OnSampleSlide(MQWidgetBase* sender, MQDocument doc);
     BOOL OnSettingsUpdate(MQWidgetBase* sender, MQDocument doc);
+    BOOL OnLoadClicked(MQWidgetBase* sender, MQDocument doc);
     BOOL OnOKClicked(MQWidgetBase* sender, MQDocument doc);
 
     void UpdateRelations();
@@ -45,6 +46,11 @@ private:
     MQCheckBox* m_check_merge = nullptr;
     MQCheckBox* m_check_merge_only_visible = nullptr;
 
+    MQEdit* m_edit_mask = nullptr;
+    MQCheckBox* m_check_payloads = nullptr;
+    MQEdit* m_edit_load_path = nullptr;
+    MQButton* m_button_load = nullptr;
+
     MQButton* m_button_ok = nullptr;
 
 
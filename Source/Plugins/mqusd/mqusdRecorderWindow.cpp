@@ -15,6 +15,7 @@ mqusdRecorderWindow::mqusdRecorderWindow(MQBasePlugin* plugin)
     m_options.merge_only_visible = true;
     m_options.export_blendshapes = false;
     m_options.export_skeletons = false;
+    m_options.indexed_primvars = true;
     m_options.log_info = [this](const char* message) { LogInfo(message); };
 
     setlocale(LC_ALL, "");
@@ -48,6 +49,9 @@ mqusdRecorderWindow::mqusdRecorderWindow(MQBasePlugin* plugin)
         m_check_colors = CreateCheckBox(group, L"Export Vertex Colors");
         m_check_colors->AddChangedEvent(this, &mqusdRecorderWindow::OnSettingsUpdate);
 
+        m_check_indexed = CreateCheckBox(group, L"Indexed Primvars");
+        m_check_indexed->AddChangedEvent(this, &mqusdRecorderWindow::OnSettingsUpdate);
+
         m_check_materials = CreateCheckBox(group, L"Export Materials");
         m_check_materials->AddChangedEvent(this, &mqusdRecorderWindow::OnSettingsUpdate);
     }
@@ -92,6 +96,22 @@ mqusdRecorderWindow::mqusdRecorderWindow(MQBasePlugin* plugin)
             m_edit_interval->SetNumeric(MQEdit::NUMERIC_DOUBLE);
             m_edit_interval->AddChangedEvent(this, &mqusdRecorderWindow::OnSettingsUpdate);
         }
+        {
+            MQFrame* hf = CreateHorizontalFrame(vf);
+            CreateLabel(hf, L"Checkpoint Interval (second)");
+
+            m_edit_checkpoint = CreateEdit(hf);
+            m_edit_checkpoint->SetNumeric(MQEdit::NUMERIC_DOUBLE);
+            m_edit_checkpoint->AddChangedEvent(this, &mqusdRecorderWindow::OnSettingsUpdate);
+        }
+        {
+            MQFrame* hf = CreateHorizontalFrame(vf);
+            CreateLabel(hf, L"Frames per Clip");
+
+            m_edit_clip_frames = CreateEdit(hf);
+            m_edit_clip_frames->SetNumeric(MQEdit::NUMERIC_INT);
+            m_edit_clip_frames->AddChangedEvent(this, &mqusdRecorderWindow::OnSettingsUpdate);
+        }
 
         m_button_recording = CreateButton(vf, L"Start Recording");
         m_button_recording->AddClickEvent(this, &mqusdRecorderWindow::OnRecordingClicked);
@@ -138,12 +158,21 @@ BOOL mqusdRecorderWindow::OnSettingsUpdate(MQWidgetBase* sender, MQDocument doc)
         auto value = std::atof(str.c_str());
         opt.capture_interval = value;
     }
+    {
+        auto str = mu::ToMBS(m_edit_checkpoint->GetText());
+        opt.checkpoint_interval = std::max(std::atof(str.c_str()), 0.0);
+    }
+    {
+        auto str = mu::ToMBS(m_edit_clip_frames->GetText());
+        opt.clip_frames = std::max(std::atoi(str.c_str()), 0);
+    }
     opt.freeze_mirror = m_check_mirror->GetChecked();
     opt.freeze_lathe = m_check_lathe->GetChecked();
     opt.freeze_subdiv = m_check_subdiv->GetChecked();
 
     opt.export_normals = m_check_normals->GetChecked();
     opt.export_colors = m_check_colors->GetChecked();
+    opt.indexed_primvars = m_check_indexed->GetChecked();
     opt.export_materials = m_check_materials->GetChecked();
 
     opt.flip_v = m_check_flip_v->GetChecked();
@@ -205,6 +234,12 @@ void mqusdRecorderWindow::SyncSettings()
     swprintf(buf, buf_len, L"%.2lf", opt.capture_interval);
     m_edit_interval->SetText(buf);
 
+    swprintf(buf, buf_len, L"%.2lf", opt.checkpoint_interval);
+    m_edit_checkpoint->SetText(buf);
+
+    swprintf(buf, buf_len, L"%d", opt.clip_frames);
+    m_edit_clip_frames->SetText(buf);
+
     swprintf(buf, buf_len, L"%.3f", opt.scale_factor);
     m_edit_scale->SetText(buf);
 
@@ -214,6 +249,7 @@ void mqusdRecorderWindow::SyncSettings()
 
     m_check_normals->SetChecked(opt.export_normals);
     m_check_colors->SetChecked(opt.export_colors);
+    m_check_indexed->SetChecked(opt.indexed_primvars);
     m_check_materials->SetChecked(opt.export_materials);
 
     m_check_flip_v->SetChecked(opt.flip_v);
@@ -30,10 +30,13 @@ private:
 
     MQFrame* m_frame_settings = nullptr;
     MQEdit* m_edit_interval = nullptr;
+    MQEdit* m_edit_checkpoint = nullptr;
+    MQEdit* m_edit_clip_frames = nullptr;
     MQEdit* m_edit_scale = nullptr;
 
     MQCheckBox* m_check_normals = nullptr;
     MQCheckBox* m_check_colors = nullptr;
+    MQCheckBox* m_check_indexed = nullptr;
     MQCheckBox* m_check_materials = nullptr;
 
     MQCheckBox* m_check_mirror = nullptr;
@@ -7,11 +7,16 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <list>
 #include <functional>
 #include <memory>
 #include <sstream>
 #include <fstream>
 #include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 #include <random>
 #include <numeric>
 
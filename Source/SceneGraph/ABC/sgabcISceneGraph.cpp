@@ -67,6 +67,19 @@ static void GetValue(const Abc::IStringProperty& prop, TexturePtr& dst, abcss t)
     prop.get(dst->file_path, t);
 }
 
+template<class PropT>
+static inline bool IsTimeVarying(const PropT& prop)
+{
+    return prop && !prop.isConstant();
+}
+
+template<class SamplePtr>
+static inline size_t GetDataSize(const SamplePtr& sp)
+{
+    using value_type = typename SamplePtr::element_type::value_type;
+    return sp ? sp->size() * sizeof(value_type) : 0;
+}
+
 static void UpdateGlobalMatrix(XformNode& n)
 {
     if (n.parent_xform)
@@ -82,8 +95,10 @@ ABCINode::ABCINode(ABCINode* parent, Abc::IObject& obj, bool create_node)
     , m_scene(ABCIScene::getCurrent())
     , m_parent(parent)
 {
-    if (m_parent)
+    if (m_parent) {
         m_parent->m_children.push_back(this);
+        m_depth = m_parent->m_depth + 1;
+    }
     if (create_node)
         setNode(CreateNode<Node>(parent, obj));
 }
@@ -104,6 +119,11 @@ void ABCINode::read(abcss t)
         m_display_name_prop.get(dst.display_name, t);
 }
 
+bool ABCINode::isTimeVarying() const
+{
+    return IsTimeVarying(m_display_name_prop);
+}
+
 void ABCINode::setNode(Node* node)
 {
     m_node = node;
@@ -155,6 +175,11 @@ void ABCIXformNode::read(abcss t)
     UpdateGlobalMatrix(dst);
 }
 
+bool ABCIXformNode::isTimeVarying() const
+{
+    return super::isTimeVarying() || IsTimeVarying(m_visibility_prop) || !m_schema.isConstant();
+}
+
 
 ABCIMeshNode::ABCIMeshNode(ABCINode* parent, Abc::IObject& obj)
     : super(parent, obj, false)
@@ -177,6 +202,8 @@ void ABCIMeshNode::beforeRead()
     if (!FindProperty(m_rgba_param, params, nullptr))
         FindProperty(m_rgb_param, params, nullptr);
 
+    m_topology_variance = m_schema.getTopologyVariance();
+
     // face sets & materials
     {
         std::vector<std::string> fs_names;
@@ -221,21 +248,56 @@ void ABCIMeshNode::read(abcss t)
     if (m_schema.getNumSamples() == 0)
         return;
 
-    m_schema.get(m_sample, t);
+    // decoded samples of time-varying meshes may be in the cache (e.g. scrubbing)
+    auto& cache = m_scene->getSampleCache();
+    bool use_cache = cache.enabled() && m_schema.getNumSamples() > 1;
+    int64_t sample_index = 0;
+    std::shared_ptr<CachedSample> cached;
+    if (use_cache) {
+        sample_index = t.getIndex(m_schema.getTimeSampling(), m_schema.getNumSamples());
+        cached = std::static_pointer_cast<CachedSample>(cache.find(this, sample_index));
+    }
 
+    // samples are shared again every frame even if they are not re-read, because nodes may be modified after read.
+    // (e.g. Node::convert())
+    bool read_topology = false;
+    if (cached) {
+        read_topology = cached->sample.getFaceCounts() != m_sample.getFaceCounts() ||
+            cached->sample.getFaceIndices() != m_sample.getFaceIndices();
+        m_sample = cached->sample;
+        m_points = cached->points;
+        m_normals = cached->normals;
+        m_uvs = cached->uvs;
+        m_rgb = cached->rgb;
+        m_rgba = cached->rgba;
+        each_with_index(m_facesets, [&cached](auto& fs, int i) { fs.sample = cached->facesets[i]; });
+    }
+    else {
+        read_topology = !m_topology_fetched || m_topology_variance == AbcGeom::kHeterogenousTopology;
+        if (read_topology) {
+            // m_sample holds counts/indices/points sample pointers. so, no need to hold these by myself.
+            m_schema.get(m_sample, t);
+            m_points = m_sample.getPositions();
+            m_topology_fetched = true;
+        }
+        else if (m_topology_variance == AbcGeom::kHomogenousTopology) {
+            m_schema.getPositionsProperty().get(m_points, t);
+        }
+    }
+    dst.topology_updated = read_topology;
     {
-        // m_sample holds counts/indices/points sample pointers. so, no need to hold these by myself.
         auto counts = m_sample.getFaceCounts();
         dst.counts.share(counts->get(), counts->size());
 
         auto indices = m_sample.getFaceIndices();
         dst.indices.share(indices->get(), indices->size());
 
-        auto points = m_sample.getPositions();
-        dst.points.share((float3*)points->get(), points->size());
+        dst.points.share((float3*)m_points->get(), m_points->size());
     }
 
-    auto get_expanded_data = [this, &t, &dst](auto param, auto& sample, auto& dst_data) -> bool {
+    bool fetch_all_params = !m_params_fetched || read_topology;
+    m_params_fetched = true;
+    auto get_expanded_data = [this, &t, &dst, &cached, fetch_all_params](auto param, auto& sample, auto& dst_data) -> bool {
         if (!param || param.getNumSamples() == 0)
             return false;
 
@@ -243,7 +305,10 @@ void ABCIMeshNode::read(abcss t)
         using dst_t = typename std::remove_reference_t<decltype(dst_data)>::value_type;
         static_assert(sizeof(src_t) == sizeof(dst_t), "data size mismatch");
 
-        param.getExpanded(sample, t);
+        if (!cached && (fetch_all_params || !param.isConstant()))
+            param.getExpanded(sample, t);
+        if (!sample.getVals())
+            return false;
         const auto& values = *sample.getVals();
 
         size_t nindices = dst.indices.size();
@@ -277,17 +342,66 @@ void ABCIMeshNode::read(abcss t)
 
     // facesets
     dst.facesets.resize(m_facesets.size());
-    each_with_index(m_facesets, [&dst, &t](auto& fs, int i) {
-        fs.faceset.get(fs.sample, t);
+    each_with_index(m_facesets, [&dst, &t, &cached](auto& fs, int i) {
+        if (!cached && (!fs.fetched || !fs.faceset.isConstant())) {
+            fs.faceset.get(fs.sample, t);
+            fs.fetched = true;
+        }
         auto sp = fs.sample.getFaces();
         fs.dst->faces.share(sp->get(), sp->size());
         dst.facesets[i] = fs.dst;
     });
 
+    if (use_cache && !cached) {
+        // size of time-varying data. constant samples are shared by all entries.
+        auto entry = std::make_shared<CachedSample>();
+        size_t size = GetDataSize(m_points);
+        if (m_topology_variance == AbcGeom::kHeterogenousTopology)
+            size += GetDataSize(m_sample.getFaceCounts()) + GetDataSize(m_sample.getFaceIndices());
+        auto add_param = [&size](const auto& param, const auto& sample) {
+            if (param && !param.isConstant())
+                size += GetDataSize(sample.getVals());
+        };
+        add_param(m_schema.getNormalsParam(), m_normals);
+        add_param(m_schema.getUVsParam(), m_uvs);
+        add_param(m_rgb_param, m_rgb);
+        add_param(m_rgba_param, m_rgba);
+        for (auto& fs : m_facesets) {
+            entry->facesets.push_back(fs.sample);
+            if (!fs.faceset.isConstant())
+                size += GetDataSize(fs.sample.getFaces());
+        }
+        entry->sample = m_sample;
+        entry->points = m_points;
+        entry->normals = m_normals;
+        entry->uvs = m_uvs;
+        entry->rgb = m_rgb;
+        entry->rgba = m_rgba;
+        entry->size = size;
+        cache.insert(this, sample_index, entry);
+    }
+
     // validate
     dst.validate();
 }
 
+bool ABCIMeshNode::isTimeVarying() const
+{
+    if (super::isTimeVarying() || IsTimeVarying(m_visibility_prop))
+        return true;
+    // constant topology: counts, indices and points are constant
+    if (!m_schema.isConstant())
+        return true;
+    if (IsTimeVarying(m_schema.getNormalsParam()) || IsTimeVarying(m_schema.getUVsParam()) ||
+        IsTimeVarying(m_rgb_param) || IsTimeVarying(m_rgba_param))
+        return true;
+    for (auto& fs : m_facesets) {
+        if (fs.faceset.getNumSamples() > 1)
+            return true;
+    }
+    return false;
+}
+
 
 ABCIMaterialNode::ABCIMaterialNode(ABCINode* parent, Abc::IObject& obj)
     : super(parent, obj, false)
@@ -354,6 +468,95 @@ void ABCIMaterialNode::read(abcss t)
     GetValue(m_bump_texture_prop, dst.bump_texture, t);
 }
 
+bool ABCIMaterialNode::isTimeVarying() const
+{
+    return super::isTimeVarying() ||
+        IsTimeVarying(m_use_vertex_color_prop) ||
+        IsTimeVarying(m_double_sided_prop) ||
+        IsTimeVarying(m_diffuse_color_prop) ||
+        IsTimeVarying(m_diffuse_prop) ||
+        IsTimeVarying(m_opacity_prop) ||
+        IsTimeVarying(m_roughness_prop) ||
+        IsTimeVarying(m_ambient_color_prop) ||
+        IsTimeVarying(m_specular_color_prop) ||
+        IsTimeVarying(m_emissive_color_prop) ||
+        IsTimeVarying(m_diffuse_texture_prop) ||
+        IsTimeVarying(m_opacity_texture_prop) ||
+        IsTimeVarying(m_bump_texture_prop);
+}
+
+
+void ABCISampleCache::setBudget(size_t bytes)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_budget = bytes;
+    evict();
+}
+
+bool ABCISampleCache::enabled() const
+{
+    return m_budget > 0;
+}
+
+ABCISampleCache::EntryPtr ABCISampleCache::find(const void* owner, int64_t index)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_table.find(Key(owner, index));
+    if (it == m_table.end()) {
+        ++m_stats.cache_misses;
+        return nullptr;
+    }
+    // move to front
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    ++m_stats.cache_hits;
+    return it->second->second;
+}
+
+void ABCISampleCache::insert(const void* owner, int64_t index, EntryPtr entry)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!entry || entry->size > m_budget)
+        return;
+
+    Key key(owner, index);
+    auto it = m_table.find(key);
+    if (it != m_table.end()) {
+        m_size -= it->second->second->size;
+        m_entries.erase(it->second);
+    }
+    m_entries.emplace_front(key, entry);
+    m_table[key] = m_entries.begin();
+    m_size += entry->size;
+    evict();
+}
+
+void ABCISampleCache::evict()
+{
+    while (m_size > m_budget && !m_entries.empty()) {
+        auto& last = m_entries.back();
+        m_size -= last.second->size;
+        m_table.erase(last.first);
+        m_entries.pop_back();
+        ++m_stats.cache_evictions;
+    }
+    m_stats.cache_size = m_size;
+}
+
+void ABCISampleCache::clear()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_table.clear();
+    m_size = 0;
+    m_stats = {};
+}
+
+ReadStats ABCISampleCache::getStats()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
 
 static thread_local ABCIScene* g_current_scene;
 
@@ -378,19 +581,25 @@ bool ABCIScene::open(const char* path)
     {
         // Abc::IArchive doesn't accept wide string path. so create file stream with wide string path and pass it.
         // (VisualC++'s std::ifstream accepts wide string)
-        m_stream.reset(new std::fstream());
+        // Ogawa assigns a stream to each reading thread. open one per core so that nodes can be read in parallel.
+        int num_streams = mu::clamp((int)std::thread::hardware_concurrency(), 1, 16);
+        std::vector<std::istream*> streams;
+        for (int i = 0; i < num_streams; ++i) {
+            auto stream = std::make_shared<std::fstream>();
 #ifdef WIN32
-        auto wpath = mu::ToWCS(path);
-        m_stream->open(wpath.c_str(), std::ios::in | std::ios::binary);
+            auto wpath = mu::ToWCS(path);
+            stream->open(wpath.c_str(), std::ios::in | std::ios::binary);
 #else
-        m_stream->open(path, std::ios::in | std::ios::binary);
+            stream->open(path, std::ios::in | std::ios::binary);
 #endif
-        if (!m_stream->is_open()) {
-            close();
-            return false;
+            if (!stream->is_open()) {
+                close();
+                return false;
+            }
+            m_streams.push_back(stream);
+            streams.push_back(stream.get());
         }
 
-        std::vector< std::istream*> streams{ m_stream.get() };
         Alembic::AbcCoreOgawa::ReadArchive archive_reader(streams);
         m_archive = Abc::IArchive(archive_reader(path), Abc::kWrapExisting, Abc::ErrorHandler::kThrowPolicy);
     }
@@ -423,11 +632,13 @@ bool ABCIScene::open(const char* path)
         try {
             g_current_scene = this;
             m_abc_path = path;
+            m_sample_cache.setBudget(size_t(std::max(m_scene->open_options.sample_cache_size, 0)) * 1024 * 1024);
             m_root = new ABCIRootNode(m_archive.getTop());
             m_scene->root_node = m_root->getNode<RootNode>();
             constructTree(m_root);
             for (auto& node : m_nodes)
                 node->beforeRead();
+            setupAnimatedNodes();
         }
         catch (Alembic::Util::Exception e3) {
             close();
@@ -461,11 +672,16 @@ void ABCIScene::close()
 {
     m_root = nullptr;
     m_node_table.clear();
+    m_animated_nodes.clear();
+    m_node_levels.clear();
+    m_animated_levels.clear();
     m_nodes.clear();
+    m_read_all_nodes = true;
 
     m_archive.reset();
-    m_stream.reset();
+    m_streams.clear();
     m_abc_path.clear();
+    m_sample_cache.clear();
 }
 
 void ABCIScene::read()
@@ -476,11 +692,45 @@ void ABCIScene::read()
         time = 0.0;
 
     Abc::ISampleSelector t(time);
-    for (auto& n : m_nodes)
-        n->read(t);
+    if (m_read_all_nodes) {
+        m_read_all_nodes = false;
+        readNodes(m_node_levels, t);
+        for (auto& n : m_nodes)
+            n->m_node->updated = true;
+        m_static_nodes_updated = true;
+    }
+    else {
+        // static nodes keep the data of the last read. their flags need to be cleared only once.
+        if (m_static_nodes_updated) {
+            m_static_nodes_updated = false;
+            for (auto& n : m_nodes)
+                n->m_node->updated = n->m_animated;
+        }
+        readNodes(m_animated_levels, t);
+    }
     ++m_read_count;
 }
 
+ReadStats ABCIScene::getReadStats()
+{
+    return m_sample_cache.getStats();
+}
+
+void ABCIScene::readNodes(const std::vector<std::vector<ABCINode*>>& levels, abcss t)
+{
+    // a node depends only on its parent (global matrix). so, levels are read in order and nodes in a level in parallel.
+    for (auto& nodes : levels) {
+        mu::parallel_for(0, (int)nodes.size(), [&nodes, &t](int i) {
+            nodes[i]->read(t);
+        });
+    }
+}
+
+void ABCIScene::invalidate()
+{
+    m_read_all_nodes = true;
+}
+
 void ABCIScene::write()
 {
     // not supported
@@ -520,6 +770,11 @@ Scene* ABCIScene::getHostScene()
     return m_scene;
 }
 
+ABCISampleCache& ABCIScene::getSampleCache()
+{
+    return m_sample_cache;
+}
+
 ABCINode* ABCIScene::findABCNodeImpl(const std::string& path)
 {
     auto it = m_node_table.find(path);
@@ -641,6 +896,28 @@ void ABCIScene::setupTimeRange()
     dst.frame_count = (int)m_times.size();
 }
 
+void ABCIScene::setupAnimatedNodes()
+{
+    // global matrix depends on parents. m_nodes is ordered parents first.
+    m_animated_nodes.clear();
+    m_node_levels.clear();
+    m_animated_levels.clear();
+
+    auto add = [](std::vector<std::vector<ABCINode*>>& levels, ABCINode* n) {
+        if (levels.size() <= (size_t)n->m_depth)
+            levels.resize(n->m_depth + 1);
+        levels[n->m_depth].push_back(n);
+    };
+    for (auto& n : m_nodes) {
+        n->m_animated = n->isTimeVarying() || (n->m_parent && n->m_parent->m_animated);
+        add(m_node_levels, n.get());
+        if (n->m_animated) {
+            m_animated_nodes.push_back(n.get());
+            add(m_animated_levels, n.get());
+        }
+    }
+}
+
 void ABCIScene::registerNode(ABCINode* n)
 {
     if (n) {
@@ -6,6 +6,39 @@ namespace sg {
 class ABCIScene;
 using abcss = const Abc::ISampleSelector&;
 
+// LRU cache of decoded samples keyed by (owner node, sample index). entries are dropped in least-recently-used order
+// when the total size exceeds the budget. thread safe as nodes are read in parallel.
+class ABCISampleCache
+{
+public:
+    struct Entry
+    {
+        virtual ~Entry() {}
+        size_t size = 0; // bytes of data that are held only by this entry
+    };
+    using EntryPtr = std::shared_ptr<Entry>;
+
+    void setBudget(size_t bytes);
+    bool enabled() const;
+    EntryPtr find(const void* owner, int64_t index);
+    void insert(const void* owner, int64_t index, EntryPtr entry);
+    void clear();
+    ReadStats getStats();
+
+private:
+    using Key = std::pair<const void*, int64_t>;
+    using Entries = std::list<std::pair<Key, EntryPtr>>; // front is the most recently used
+
+    void evict();
+
+    std::mutex m_mutex;
+    Entries m_entries;
+    std::map<Key, Entries::iterator> m_table;
+    size_t m_budget = 0;
+    size_t m_size = 0;
+    ReadStats m_stats;
+};
+
 class ABCINode
 {
 public:
@@ -13,6 +46,8 @@ public:
     virtual ~ABCINode();
     virtual void beforeRead();
     virtual void read(abcss t);
+    // true if any of properties read by read() may change over time. valid after beforeRead().
+    virtual bool isTimeVarying() const;
 
     void setNode(Node* node);
     std::string getPath() const;
@@ -26,6 +61,8 @@ public:
     Node* m_node = nullptr;
     ABCINode* m_parent = nullptr;
     std::vector<ABCINode*> m_children;
+    int m_depth = 0;
+    bool m_animated = false; // time-varying or parent is animated. read() is called every frame.
 
     size_t m_num_samples = 0;
     Abc::TimeSamplingPtr m_timesampling;
@@ -50,6 +87,7 @@ using super = ABCINode;
 public:
     ABCIXformNode(ABCINode* parent, Abc::IObject& obj);
     void read(abcss t) override;
+    bool isTimeVarying() const override;
 
 protected:
     AbcGeom::IXformSchema m_schema;
@@ -65,6 +103,7 @@ public:
     ABCIMeshNode(ABCINode* parent, Abc::IObject& obj);
     void beforeRead() override;
     void read(abcss t) override;
+    bool isTimeVarying() const override;
 
 protected:
     AbcGeom::IPolyMeshSchema m_schema;
@@ -72,7 +111,15 @@ protected:
     AbcGeom::IC3fGeomParam m_rgb_param;
     AbcGeom::IC4fGeomParam m_rgba_param;
 
+    // classified at beforeRead().
+    // constant: read once. homogeneous: only positions are re-read. heterogeneous: everything is re-read.
+    // constant params are also read once and their samples are shared again every frame.
+    AbcGeom::MeshTopologyVariance m_topology_variance = AbcGeom::kHeterogenousTopology;
+    bool m_topology_fetched = false;
+    bool m_params_fetched = false;
+
     AbcGeom::IPolyMeshSchema::Sample m_sample;
+    Abc::P3fArraySamplePtr m_points;
     AbcGeom::IN3fGeomParam::Sample m_normals;
     AbcGeom::IV2fGeomParam::Sample m_uvs;
     AbcGeom::IC3fGeomParam::Sample m_rgb;
@@ -80,10 +127,23 @@ protected:
     Abc::Int32ArraySamplePtr m_material_ids;
     SharedVector<float3> m_tmp_rgb;
 
+    // samples of a frame kept in the sample cache of the scene. time-varying meshes only.
+    struct CachedSample : public ABCISampleCache::Entry
+    {
+        AbcGeom::IPolyMeshSchema::Sample sample;
+        Abc::P3fArraySamplePtr points;
+        AbcGeom::IN3fGeomParam::Sample normals;
+        AbcGeom::IV2fGeomParam::Sample uvs;
+        AbcGeom::IC3fGeomParam::Sample rgb;
+        AbcGeom::IC4fGeomParam::Sample rgba;
+        std::vector<AbcGeom::IFaceSetSchema::Sample> facesets;
+    };
+
     struct FacesetData
     {
         AbcGeom::IFaceSetSchema faceset;
         AbcGeom::IFaceSetSchema::Sample sample;
+        bool fetched = false;
         FaceSetPtr dst;
     };
     std::vector<FacesetData> m_facesets;
@@ -97,6 +157,7 @@ public:
     ABCIMaterialNode(ABCINode* parent, Abc::IObject& obj);
     void beforeRead() override;
     void read(abcss t) override;
+    bool isTimeVarying() const override;
 
 protected:
     AbcMaterial::IMaterialSchema m_schema;
@@ -132,6 +193,8 @@ public:
     bool save() override;
     void close() override;
     void read() override;
+    ReadStats getReadStats() override;
+    void invalidate() override;
     void write() override;
 
     bool isNodeTypeSupported(Node::Type type) override;
@@ -140,6 +203,7 @@ public:
     double frameToTime(int frame) override;
 
     Scene* getHostScene();
+    ABCISampleCache& getSampleCache();
     ABCINode* findABCNodeImpl(const std::string& path);
     Node* findNodeImpl(const std::string& path);
 
@@ -159,17 +223,26 @@ private:
     void registerNode(ABCINode* n);
     void constructTree(ABCINode* n);
     void setupTimeRange();
+    void setupAnimatedNodes();
+    void readNodes(const std::vector<std::vector<ABCINode*>>& levels, abcss t);
 
     std::string m_abc_path;
-    std::shared_ptr<std::fstream> m_stream;
+    std::vector<std::shared_ptr<std::fstream>> m_streams; // one per worker thread for concurrent sample reads
     Abc::IArchive m_archive;
     std::vector<ABCINodePtr> m_nodes;
     std::map<std::string, ABCINode*> m_node_table;
+    std::vector<ABCINode*> m_animated_nodes; // after the first read, only these are read
+    // nodes grouped by depth. nodes in the same level are read in parallel.
+    std::vector<std::vector<ABCINode*>> m_node_levels;
+    std::vector<std::vector<ABCINode*>> m_animated_levels;
     ABCIRootNode* m_root = nullptr;
 
     Scene* m_scene = nullptr;
     int m_read_count = 0;
+    bool m_read_all_nodes = true;
+    bool m_static_nodes_updated = false;
     RawVector<double> m_times;
+    ABCISampleCache m_sample_cache;
 };
 
 SceneInterface* CreateABCIScene(Scene* scene);
@@ -3,6 +3,10 @@
 #define sgabcAttrDisplayName        "displayName"
 #define sgabcAttrVertexColor        "C"
 #define sgabcAttrMaterialBinding    "material:binding"
+#define sgabcAttrPrototypes         "prototypes"
+#define sgabcAttrProtoIndices       "protoIndices"
+#define sgabcAttrOrientation        "orient"
+#define sgabcAttrScale              "scale"
 
 // some of these are based on Preview Material Specification
 // https://github.com/alembic/alembic/wiki/Alembic-Preview-Material-Specification
@@ -64,13 +64,22 @@ ABCONode::~ABCONode()
 {
 }
 
+NodePtr ABCONode::snapshot()
+{
+    return std::make_shared<Node>(*getNode());
+}
+
 void ABCONode::beforeWrite()
 {
 }
 
+void ABCONode::prepareSample(double /*t*/)
+{
+}
+
 void ABCONode::write(double /*t*/)
 {
-    const auto& src = *getNode();
+    const auto& src = *getSource();
 
     // display name
     if (!m_display_name_prop && !src.display_name.empty() && src.display_name != getName()) {
@@ -105,7 +114,8 @@ std::string ABCONode::makeUniqueName(const std::string& name) const
             if (n == c->getName())
                 return false;
         }
-        return true;
+        // objects that are not nodes (e.g. instances of ABCOInstancerNode)
+        return m_obj->getChildHeader(n) == nullptr;
     });
 }
 
@@ -118,19 +128,25 @@ ABCORootNode::ABCORootNode(Abc::OObject* obj)
 }
 
 
-ABCOXformNode::ABCOXformNode(ABCONode* parent, Abc::OObject* obj)
+ABCOXformNode::ABCOXformNode(ABCONode* parent, Abc::OObject* obj, bool create_node)
     : super(parent, obj, false)
 {
     m_schema = dynamic_cast<AbcGeom::OXform*>(m_obj)->getSchema();
-    setNode(CreateNode<XformNode>(parent, obj));
+    if (create_node)
+        setNode(CreateNode<XformNode>(parent, obj));
 
     m_visibility_prop = AbcGeom::CreateVisibilityProperty(*m_obj, 1);
 }
 
+NodePtr ABCOXformNode::snapshot()
+{
+    return std::make_shared<XformNode>(*getNode<XformNode>());
+}
+
 void ABCOXformNode::write(double t)
 {
     super::write(t);
-    const auto& src = *getNode<XformNode>();
+    const auto& src = *getSource<XformNode>();
 
     // visibility
     int8_t vis = int8_t(src.visibility ? AbcGeom::kVisibilityVisible : AbcGeom::kVisibilityHidden);
@@ -144,6 +160,154 @@ void ABCOXformNode::write(double t)
 }
 
 
+ABCOInstancerNode::ABCOInstancerNode(ABCONode* parent, Abc::OObject* obj)
+    : super(parent, obj, false)
+{
+    setNode(CreateNode<InstancerNode>(parent, obj));
+}
+
+NodePtr ABCOInstancerNode::snapshot()
+{
+    auto ret = std::make_shared<InstancerNode>(*getNode<InstancerNode>());
+    auto& dst = *ret;
+    dst.proto_indices.detach();
+    dst.matrices.detach();
+    dst.proto_records.clear();
+    return ret;
+}
+
+void ABCOInstancerNode::prepareSample(double t)
+{
+    super::prepareSample(t);
+    const auto& src = *getSource<InstancerNode>();
+    if (!m_scene->getHostScene()->write_options.points_instancing)
+        return;
+
+    m_proto_paths.clear();
+    for (auto proto : src.protos)
+        m_proto_paths.push_back(proto && proto->impl ? GetABCPath(proto) : std::string());
+
+    // OPoints rejects null arrays even if they are empty. keep data() of the buffers valid.
+    size_t n = src.matrices.size();
+    m_positions.reserve(1);
+    m_ids.reserve(1);
+    m_positions.resize_discard(n);
+    m_ids.resize_discard(n);
+    m_orientations.resize_discard(n);
+    m_scales.resize_discard(n);
+    m_rotations.resize_discard(n);
+    mu::ExtractTRS(src.matrices.cdata(), (float3*)m_positions.data(), m_rotations.data(), (float3*)m_scales.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+        auto& r = m_rotations[i];
+        m_ids[i] = i;
+        m_orientations[i] = Imath::Quatf(r.w, r.x, r.y, r.z);
+    }
+}
+
+void ABCOInstancerNode::write(double t)
+{
+    uint32_t wc = (uint32_t)m_schema.getNumSamples();
+    super::write(t);
+    const auto& src = *getSource<InstancerNode>();
+
+    if (m_scene->getHostScene()->write_options.points_instancing)
+        writePoints(src, wc);
+    else
+        writeInstances(src, wc);
+}
+
+void ABCOInstancerNode::writeInstances(const InstancerNode& src, uint32_t wc)
+{
+    auto add_instance = [&](Node* proto) -> int {
+        auto abc_proto = GetABCNode(proto);
+
+        InstanceData data;
+        data.xform = std::make_shared<AbcGeom::OXform>(*m_obj, makeUniqueName("instance"), 1);
+        data.visibility = AbcGeom::CreateVisibilityProperty(*data.xform, 1);
+        data.proto = proto;
+
+        // hidden until this frame
+        AbcGeom::XformSample identity;
+        auto schema = data.xform->getSchema();
+        while (schema.getNumSamples() < wc)
+            schema.set(identity);
+        PadSamples(data.visibility, wc, (int8_t)AbcGeom::kVisibilityHidden);
+
+        data.xform->addChildInstance(*abc_proto->m_obj, abc_proto->getName());
+        m_instances.push_back(data);
+        return (int)m_instances.size() - 1;
+    };
+
+    size_t num_instances = src.matrices.size();
+    size_t num_protos = src.protos.size();
+    if (m_instance_slots.size() < num_instances)
+        m_instance_slots.resize(num_instances, -1);
+
+    AbcGeom::XformSample sample;
+    for (size_t ii = 0; ii < num_instances; ++ii) {
+        int pi = ii < src.proto_indices.size() ? src.proto_indices[ii] : 0;
+        if (pi < 0 || pi >= (int)num_protos || !src.protos[pi] || !src.protos[pi]->impl)
+            continue;
+
+        Node* proto = src.protos[pi];
+        int& slot = m_instance_slots[ii];
+        if (slot < 0 || m_instances[slot].proto != proto)
+            slot = add_instance(proto);
+
+        auto& data = m_instances[slot];
+        double4x4 mat;
+        mat.assign(src.matrices[ii]);
+        sample.setMatrix((abcM44d&)mat);
+        data.xform->getSchema().set(sample);
+        data.visibility.set((int8_t)AbcGeom::kVisibilityVisible);
+        data.write_count = wc + 1;
+    }
+
+    // instances that are gone or retargeted
+    for (auto& data : m_instances) {
+        if (data.write_count != wc + 1) {
+            data.xform->getSchema().setFromPrevious();
+            data.visibility.set((int8_t)AbcGeom::kVisibilityHidden);
+            data.write_count = wc + 1;
+        }
+    }
+}
+
+void ABCOInstancerNode::writePoints(const InstancerNode& src, uint32_t wc)
+{
+    if (!m_points) {
+        m_points = std::make_shared<AbcGeom::OPoints>(*m_obj, makeUniqueName("points"), 1);
+        m_points_schema = m_points->getSchema();
+        auto arb = m_points_schema.getArbGeomParams();
+        m_prototypes_prop = Abc::OStringArrayProperty(arb, sgabcAttrPrototypes, 1);
+        m_proto_indices_param = AbcGeom::OInt32GeomParam(arb, sgabcAttrProtoIndices, false, AbcGeom::GeometryScope::kVaryingScope, 1, 1);
+        m_orientations_param = AbcGeom::OQuatfGeomParam(arb, sgabcAttrOrientation, false, AbcGeom::GeometryScope::kVaryingScope, 1, 1);
+        m_scales_param = AbcGeom::OV3fGeomParam(arb, sgabcAttrScale, false, AbcGeom::GeometryScope::kVaryingScope, 1, 1);
+
+        // empty until this frame
+        auto scope = AbcGeom::GeometryScope::kVaryingScope;
+        while (m_points_schema.getNumSamples() < wc)
+            m_points_schema.set(AbcGeom::OPointsSchema::Sample(Abc::P3fArraySample(m_positions.cdata(), 0), Abc::UInt64ArraySample(m_ids.cdata(), 0)));
+        PadSamples(m_prototypes_prop, wc);
+        PadSamples(m_proto_indices_param, wc, AbcGeom::OInt32GeomParam::Sample(Abc::Int32ArraySample(), scope));
+        PadSamples(m_orientations_param, wc, AbcGeom::OQuatfGeomParam::Sample(Abc::QuatfArraySample(), scope));
+        PadSamples(m_scales_param, wc, AbcGeom::OV3fGeomParam::Sample(Abc::V3fArraySample(), scope));
+    }
+
+    size_t n = m_positions.size();
+    m_points_schema.set(AbcGeom::OPointsSchema::Sample(
+        Abc::P3fArraySample(m_positions.cdata(), n),
+        Abc::UInt64ArraySample(m_ids.cdata(), n)));
+    m_prototypes_prop.set(Abc::StringArraySample(m_proto_paths));
+    m_proto_indices_param.set(AbcGeom::OInt32GeomParam::Sample(
+        Abc::Int32ArraySample(src.proto_indices.cdata(), src.proto_indices.size()), AbcGeom::GeometryScope::kVaryingScope));
+    m_orientations_param.set(AbcGeom::OQuatfGeomParam::Sample(
+        Abc::QuatfArraySample(m_orientations.cdata(), n), AbcGeom::GeometryScope::kVaryingScope));
+    m_scales_param.set(AbcGeom::OV3fGeomParam::Sample(
+        Abc::V3fArraySample(m_scales.cdata(), n), AbcGeom::GeometryScope::kVaryingScope));
+}
+
+
 ABCOMeshNode::ABCOMeshNode(ABCONode* parent, Abc::OObject* obj)
     : super(parent, obj, false)
 {
@@ -153,42 +317,105 @@ ABCOMeshNode::ABCOMeshNode(ABCONode* parent, Abc::OObject* obj)
     m_visibility_prop = AbcGeom::CreateVisibilityProperty(*m_obj, 1);
 }
 
+NodePtr ABCOMeshNode::snapshot()
+{
+    // copy constructor of SharedVector shares data. detach() makes copies.
+    auto ret = std::make_shared<MeshNode>(*getNode<MeshNode>());
+    auto& dst = *ret;
+    dst.points.detach();
+    dst.normals.detach();
+    dst.uvs.detach();
+    dst.colors.detach();
+    dst.counts.detach();
+    dst.indices.detach();
+    for (auto& fs : dst.facesets) {
+        fs = fs->clone();
+        fs->faces.detach();
+    }
+    return ret;
+}
+
+template<class T>
+bool ABCOMeshNode::HeldArray<T>::update(const T* v, size_t n)
+{
+    if (valid && values.size() == n && (n == 0 || std::memcmp(values.cdata(), v, sizeof(T) * n) == 0))
+        return false;
+    values.assign(v, n);
+    valid = true;
+    return true;
+}
+
 void ABCOMeshNode::beforeWrite()
 {
     super::beforeWrite();
 }
 
-void ABCOMeshNode::write(double t)
+void ABCOMeshNode::prepareSample(double t)
 {
-    super::write(t);
-    const auto& src = *getNode<MeshNode>();
-    uint32_t wc = (uint32_t)m_schema.getNumSamples();
-
-    // visibility
-    int8_t vis = int8_t(src.visibility ? AbcGeom::kVisibilityVisible : AbcGeom::kVisibilityHidden);
-    m_visibility_prop.set(vis);
+    super::prepareSample(t);
+    const auto& src = *getSource<MeshNode>();
 
+    // arrays not set to the sample are written by setFromPrevious()
     m_sample.reset();
-    m_sample.setFaceIndices(Abc::Int32ArraySample(src.indices.cdata(), src.indices.size()));
-    m_sample.setFaceCounts(Abc::Int32ArraySample(src.counts.cdata(), src.counts.size()));
-    m_sample.setPositions(Abc::P3fArraySample((const abcV3*)src.points.cdata(), src.points.size()));
-    {
+    if (m_held_indices.update(src.indices.cdata(), src.indices.size()))
+        m_sample.setFaceIndices(Abc::Int32ArraySample(src.indices.cdata(), src.indices.size()));
+    if (m_held_counts.update(src.counts.cdata(), src.counts.size()))
+        m_sample.setFaceCounts(Abc::Int32ArraySample(src.counts.cdata(), src.counts.size()));
+    if (m_held_points.update(src.points.cdata(), src.points.size()))
+        m_sample.setPositions(Abc::P3fArraySample((const abcV3*)src.points.cdata(), src.points.size()));
+    if (m_held_normals.update(src.normals.cdata(), src.normals.size())) {
         m_normals.setVals(Abc::V3fArraySample((const abcV3*)src.normals.cdata(), src.normals.size()));
         m_sample.setNormals(m_normals);
     }
-    {
+    if (m_held_uvs.update(src.uvs.cdata(), src.uvs.size())) {
         m_uvs.setVals(Abc::V2fArraySample((const abcV2*)src.uvs.cdata(), src.uvs.size()));
         m_sample.setUVs(m_uvs);
     }
+
+    // the color param is created by write() when colors appear
+    m_colors_changed = !src.colors.empty() && m_held_colors.update(src.colors.cdata(), src.colors.size());
+
+    // faces of an empty sample are written by setFromPrevious(). facesets are created by write().
+    for (auto& kvp : m_facesets)
+        kvp.second.sample = {};
+    for (auto& fs : src.facesets) {
+        auto mat = fs->material;
+        if (!mat)
+            continue;
+
+        auto& data = m_facesets[mat->id];
+        if (data.held_faces.update(fs->faces.cdata(), fs->faces.size()))
+            data.sample.setFaces(Abc::Int32ArraySample(fs->faces.cdata(), fs->faces.size()));
+    }
+}
+
+void ABCOMeshNode::write(double t)
+{
+    super::write(t);
+    const auto& src = *getSource<MeshNode>();
+    uint32_t wc = (uint32_t)m_schema.getNumSamples();
+
+    // visibility
+    int8_t vis = int8_t(src.visibility ? AbcGeom::kVisibilityVisible : AbcGeom::kVisibilityHidden);
+    m_visibility_prop.set(vis);
+
+    // samples are made by prepareSample()
     m_schema.set(m_sample);
 
     if(!src.colors.empty()){
         if (!m_rgba_param)
             m_rgba_param = AbcGeom::OC4fGeomParam(m_schema.getArbGeomParams(), sgabcAttrVertexColor, false, AbcGeom::GeometryScope::kFacevaryingScope, 1, 1);
 
+        // padded samples differ from the held values
+        bool padded = m_rgba_param.getNumSamples() < wc;
         PadSamples(m_rgba_param, wc);
-        m_rgba.setVals(Abc::C4fArraySample((const abcC4*)src.colors.cdata(), src.colors.size()));
-        m_rgba_param.set(m_rgba);
+        if (m_colors_changed || padded) {
+            m_rgba.setVals(Abc::C4fArraySample((const abcC4*)src.colors.cdata(), src.colors.size()));
+            m_rgba_param.set(m_rgba);
+        }
+        else {
+            m_rgba_param.setFromPrevious();
+        }
     }
 
 
@@ -210,10 +437,9 @@ void ABCOMeshNode::write(double t)
         // first sample of OFaceSet must contain faces. so, add dummy.
         // it will be ignored when import.
         int dummy[] = { 0 };
-        data.sample.setFaces(Abc::Int32ArraySample(dummy, 1));
-        PadSamples(data.faceset, wc, data.sample);
-
-        data.sample.setFaces(Abc::Int32ArraySample(fs->faces.cdata(), fs->faces.size()));
+        AbcGeom::OFaceSetSchema::Sample dummy_sample;
+        dummy_sample.setFaces(Abc::Int32ArraySample(dummy, 1));
+        PadSamples(data.faceset, wc, dummy_sample);
     }
     for (auto& kvp : m_facesets) {
         auto& data = kvp.second;
@@ -230,10 +456,15 @@ ABCOMaterialNode::ABCOMaterialNode(ABCONode* parent, Abc::OObject* obj)
     setNode(CreateNode<MaterialNode>(parent, obj));
 }
 
+NodePtr ABCOMaterialNode::snapshot()
+{
+    return std::make_shared<MaterialNode>(*getNode<MaterialNode>());
+}
+
 void ABCOMaterialNode::beforeWrite()
 {
     super::beforeWrite();
-    const auto& src = *getNode<MaterialNode>();
+    const auto& src = *getSource<MaterialNode>();
 
     auto shader_type = ToString(src.shader_type);
     m_schema.setShader(mqabcMaterialTarget, shader_type, src.getName());
@@ -261,7 +492,7 @@ void ABCOMaterialNode::write(double t)
     if (!m_shader_params)
         return;
 
-    const auto& src = *getNode<MaterialNode>();
+    const auto& src = *getSource<MaterialNode>();
     uint32_t wc = (uint32_t)m_diffuse_color_prop.getNumSamples();
 
     m_use_vertex_color_prop.set(src.use_vertex_color);
@@ -340,12 +571,20 @@ bool ABCOScene::create(const char* path)
 
 bool ABCOScene::save()
 {
-    // not supported
+    // samples are written to the archive on write(). just wait for queued frames.
+    waitWriter();
     return true;
 }
 
+bool ABCOScene::checkpoint()
+{
+    // not supported. Ogawa writes its index on close and Alembic has no way to flush the archive before that.
+    return false;
+}
+
 void ABCOScene::close()
 {
+    stopWriter();
     if (m_keep_time) {
         auto ts = Abc::TimeSampling(Abc::TimeSamplingType(Abc::TimeSamplingType::kAcyclic), m_timeline);
         *m_archive.getTimeSampling(1) = ts;
@@ -358,6 +597,7 @@ void ABCOScene::close()
     m_archive.reset();
     m_abc_path.clear();
     m_timeline.clear();
+    m_stats = {};
 }
 
 void ABCOScene::read()
@@ -372,13 +612,83 @@ void ABCOScene::write()
     if (IsDefaultTime(time))
         time = 0.0;
 
-    for (auto& n : m_nodes) {
-        if (n->m_write_count++ == 0)
-            n->beforeWrite();
-        n->write(time);
+    auto frame = std::make_shared<Frame>();
+    frame->time = time;
+    frame->sources.resize(m_nodes.size());
+
+    int max_queued_frames = m_scene->write_options.max_queued_frames;
+    if (max_queued_frames <= 0) {
+        // write synchronously. nodes are referred directly.
+        waitWriter();
+        transform_container(frame->sources, m_nodes, [](NodePtr& d, ABCONodePtr& s) {
+            d = NodePtr(s->m_node, [](Node*) {});
+        });
+        mu::ScopedTimer timer;
+        writeFrame(*frame);
+        float elapsed = timer.elapsed();
+
+        // getWriteStats() may be called from other threads
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        m_stats.last_write_time = elapsed;
+        ++m_stats.frames_written;
+        return;
+    }
+
+    // m_nodes is modified only on this thread. no need to lock to read it here.
+    mu::parallel_for(0, (int)m_nodes.size(), [this, &frame](int i) {
+        frame->sources[i] = m_nodes[i]->snapshot();
+    });
+
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+    if (!m_writer.joinable()) {
+        m_stop_writer = false;
+        m_writer = std::thread([this]() { writerLoop(); });
+    }
+    if ((int)m_queue.size() >= max_queued_frames) {
+        // back pressure
+        mu::ScopedTimer timer;
+        m_queue_cond.wait(lock, [this, max_queued_frames]() { return (int)m_queue.size() < max_queued_frames; });
+        m_stats.stall_time += timer.elapsed();
+        ++m_stats.stall_count;
+    }
+    m_queue.push_back(frame);
+    m_stats.queue_depth = (int)m_queue.size();
+    m_stats.max_queue_depth = std::max(m_stats.max_queue_depth, m_stats.queue_depth);
+    lock.unlock();
+    m_queue_cond.notify_all();
+}
+
+WriteStats ABCOScene::getWriteStats()
+{
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+    return m_stats;
+}
+
+void ABCOScene::writeFrame(Frame& frame)
+{
+    std::unique_lock<std::mutex> lock(m_archive_mutex);
+    g_current_scene = this;
+
+    // nodes created after the frame was queued start from the next frame
+    size_t n = std::min(frame.sources.size(), m_nodes.size());
+    for (size_t i = 0; i < n; ++i) {
+        auto& node = m_nodes[i];
+        node->m_source = frame.sources[i];
+        if (node->m_write_count++ == 0)
+            node->beforeWrite();
+    }
+    // making samples is independent per node. only writing them to the archive needs to be serial.
+    mu::parallel_for(0, (int)n, [this, &frame](int i) {
+        m_nodes[i]->prepareSample(frame.time);
+    });
+    for (size_t i = 0; i < n; ++i) {
+        auto& node = m_nodes[i];
+        node->write(frame.time);
+        node->m_source = nullptr;
     }
     ++m_write_count;
 
+    double time = frame.time;
     if (!std::isnan(time)) {
         if (m_keep_time)
             m_timeline.push_back(time);
@@ -387,6 +697,60 @@ void ABCOScene::write()
     }
 }
 
+void ABCOScene::writerLoop()
+{
+    for (;;) {
+        FramePtr frame;
+        {
+            std::unique_lock<std::mutex> lock(m_queue_mutex);
+            m_queue_cond.wait(lock, [this]() { return !m_queue.empty() || m_stop_writer; });
+            if (m_queue.empty())
+                break; // stop requested and all frames are written
+            frame = m_queue.front();
+            m_queue.pop_front();
+            m_writing = true;
+        }
+        m_queue_cond.notify_all();
+
+        mu::ScopedTimer timer;
+        try {
+            writeFrame(*frame);
+        }
+        catch (std::exception& e) {
+            // Alembic::Util::Exception and std::bad_alloc etc. must not terminate the writer thread
+            sgDbgPrint("ABCOScene::writerLoop(): %s\n", e.what());
+        }
+        float elapsed = timer.elapsed();
+
+        {
+            std::unique_lock<std::mutex> lock(m_queue_mutex);
+            m_writing = false;
+            m_stats.queue_depth = (int)m_queue.size();
+            m_stats.last_write_time = elapsed;
+            ++m_stats.frames_written;
+        }
+        m_queue_cond.notify_all();
+    }
+}
+
+void ABCOScene::waitWriter()
+{
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+    m_queue_cond.wait(lock, [this]() { return m_queue.empty() && !m_writing; });
+}
+
+void ABCOScene::stopWriter()
+{
+    if (!m_writer.joinable())
+        return;
+    {
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        m_stop_writer = true;
+    }
+    m_queue_cond.notify_all();
+    m_writer.join();
+}
+
 void ABCOScene::registerNode(ABCONode* n)
 {
     if (n) {
@@ -416,7 +780,8 @@ bool ABCOScene::isNodeTypeSupported(Node::Type type)
     switch (type) {
     case Node::Type::Mesh:     // 
     case Node::Type::Xform:    // 
-    case Node::Type::Material: // fall through
+    case Node::Type::Material: // 
+    case Node::Type::Instancer: // fall through
         return true;
     default:
         return false;
@@ -427,10 +792,14 @@ Node* ABCOScene::createNode(Node* parent_, const char* name, Node::Type type)
 {
     auto parent = parent_ ? (ABCONode*)parent_->impl : nullptr;
     ABCONode* ret = nullptr;
+
+    // the writer thread may be writing to the archive
+    std::unique_lock<std::mutex> lock(m_archive_mutex);
     switch (type) {
     case Node::Type::Mesh: ret = createNodeImpl<ABCOMeshNode>(parent, name); break;
     case Node::Type::Xform: ret = createNodeImpl<ABCOXformNode>(parent, name); break;
     case Node::Type::Material: ret = createNodeImpl<ABCOMaterialNode>(parent, name); break;
+    case Node::Type::Instancer: ret = createNodeImpl<ABCOInstancerNode>(parent, name); break;
     default: ret = createNodeImpl<ABCONode>(parent, name); break;
     }
 
@@ -15,7 +15,11 @@ public:
 
     ABCONode(ABCONode* parent, Abc::OObject* obj, bool create_node = true);
     virtual ~ABCONode();
+    // copy of the node data that beforeWrite() and write() refer. called on the caller thread of ABCOScene::write().
+    virtual NodePtr snapshot();
     virtual void beforeWrite();
+    // called every frame before write(), in parallel with other nodes. make samples here. must not touch the archive.
+    virtual void prepareSample(double t);
     virtual void write(double t);
 
     void setNode(Node* node);
@@ -26,10 +30,15 @@ public:
     template<class NodeT = Node, sgEnableIf(std::is_base_of<Node, NodeT>::value)>
     NodeT* getNode() { return static_cast<NodeT*>(m_node); }
 
+    // data to write. m_node itself or its snapshot if written on the writer thread.
+    template<class NodeT = Node, sgEnableIf(std::is_base_of<Node, NodeT>::value)>
+    const NodeT* getSource() { return static_cast<const NodeT*>(m_source.get()); }
+
 public:
     Abc::OObject* m_obj;
     ABCOScene* m_scene = nullptr;
     Node* m_node = nullptr;
+    NodePtr m_source;
     ABCONode* m_parent = nullptr;
     std::vector<ABCONode*> m_children;
     uint32_t m_write_count = 0;
@@ -55,7 +64,8 @@ using super = ABCONode;
 public:
     DefSchemaTraits(AbcGeom::OXform);
 
-    ABCOXformNode(ABCONode* parent, Abc::OObject* obj);
+    ABCOXformNode(ABCONode* parent, Abc::OObject* obj, bool create_node = true);
+    NodePtr snapshot() override;
     void write(double t) override;
 
 protected:
@@ -65,6 +75,48 @@ protected:
 };
 
 
+// prototypes are written once as regular nodes and referred from instances.
+// by default each instance is a child OXform of the instancer that has an Alembic instance of its prototype.
+// with WriteOptions::points_instancing, instances are written as an OPoints with per-point prototype index, orientation and scale.
+class ABCOInstancerNode : public ABCOXformNode
+{
+using super = ABCOXformNode;
+public:
+    ABCOInstancerNode(ABCONode* parent, Abc::OObject* obj);
+    NodePtr snapshot() override;
+    void prepareSample(double t) override;
+    void write(double t) override;
+
+protected:
+    void writeInstances(const InstancerNode& src, uint32_t wc);
+    void writePoints(const InstancerNode& src, uint32_t wc);
+
+    struct InstanceData
+    {
+        std::shared_ptr<AbcGeom::OXform> xform;
+        AbcGeom::OVisibilityProperty visibility;
+        Node* proto = nullptr;
+        uint32_t write_count = 0;
+    };
+    // Alembic instances can't be retargeted. an instance whose prototype is changed gets a new xform.
+    std::vector<InstanceData> m_instances;
+    std::vector<int> m_instance_slots; // instance index -> index of m_instances
+
+    std::shared_ptr<AbcGeom::OPoints> m_points;
+    AbcGeom::OPointsSchema m_points_schema;
+    Abc::OStringArrayProperty m_prototypes_prop;
+    AbcGeom::OInt32GeomParam m_proto_indices_param;
+    AbcGeom::OQuatfGeomParam m_orientations_param;
+    AbcGeom::OV3fGeomParam m_scales_param;
+    RawVector<abcV3> m_positions;
+    RawVector<uint64_t> m_ids;
+    RawVector<Imath::Quatf> m_orientations;
+    RawVector<abcV3> m_scales;
+    RawVector<quatf> m_rotations; // result of mu::ExtractTRS(). converted to m_orientations
+    std::vector<std::string> m_proto_paths;
+};
+
+
 class ABCOMeshNode : public ABCONode
 {
 using super = ABCONode;
@@ -72,14 +124,36 @@ public:
     DefSchemaTraits(AbcGeom::OPolyMesh);
 
     ABCOMeshNode(ABCONode* parent, Abc::OObject* obj);
+    NodePtr snapshot() override;
     void beforeWrite() override;
+    void prepareSample(double t) override;
     void write(double t) override;
 
 protected:
+    // last written values. Alembic hashes every array it receives to find identical samples.
+    // arrays that are identical to the previous sample are not passed and written by setFromPrevious() instead.
+    template<class T>
+    struct HeldArray
+    {
+        RawVector<T> values;
+        bool valid = false;
+
+        // returns true if v differs from the held values
+        bool update(const T* v, size_t n);
+    };
+
     AbcGeom::OPolyMeshSchema m_schema;
     AbcGeom::OVisibilityProperty m_visibility_prop;
     AbcGeom::OC4fGeomParam m_rgba_param;
 
+    HeldArray<float3> m_held_points;
+    HeldArray<float3> m_held_normals;
+    HeldArray<float2> m_held_uvs;
+    HeldArray<float4> m_held_colors;
+    HeldArray<int> m_held_counts;
+    HeldArray<int> m_held_indices;
+    bool m_colors_changed = false;
+
     AbcGeom::OPolyMeshSchema::Sample m_sample;
     AbcGeom::ON3fGeomParam::Sample m_normals;
     AbcGeom::OV2fGeomParam::Sample m_uvs;
@@ -89,6 +163,7 @@ protected:
     {
         AbcGeom::OFaceSetSchema faceset;
         AbcGeom::OFaceSetSchema::Sample sample;
+        HeldArray<int> held_faces;
     };
     std::map<uint32_t, FacesetData> m_facesets;
 };
@@ -101,6 +176,7 @@ public:
     DefSchemaTraits(AbcMaterial::OMaterial);
 
     ABCOMaterialNode(ABCONode* parent, Abc::OObject* obj);
+    NodePtr snapshot() override;
     void beforeWrite() override;
     void write(double t) override;
 
@@ -137,9 +213,11 @@ public:
     bool open(const char* path) override;
     bool create(const char* path) override;
     bool save() override;
+    bool checkpoint() override;
     void close() override;
     void read() override;
     void write() override;
+    WriteStats getWriteStats() override;
 
     bool isNodeTypeSupported(Node::Type type) override;
     Node* createNode(Node* parent, const char* name, Node::Type type) override;
@@ -165,8 +243,19 @@ public:
     }
 
 private:
+    struct Frame
+    {
+        double time = 0.0;
+        std::vector<NodePtr> sources; // correspond to m_nodes
+    };
+    using FramePtr = std::shared_ptr<Frame>;
+
     void registerNode(ABCONode* n);
     template<class NodeT> ABCONode* createNodeImpl(ABCONode* parent, const char* name);
+    void writeFrame(Frame& frame);
+    void writerLoop();
+    void waitWriter();
+    void stopWriter();
 
     std::string m_abc_path;
     Abc::OArchive m_archive;
@@ -181,6 +270,16 @@ private:
 
     bool m_keep_time = false;
     std::vector<abcChrono> m_timeline;
+
+    // writer thread. write() queues snapshots of nodes and the writer thread writes them to the archive.
+    std::thread m_writer;
+    std::mutex m_archive_mutex; // archive and m_nodes. createNode() waits for the frame being written.
+    std::mutex m_queue_mutex;
+    std::condition_variable m_queue_cond;
+    std::deque<FramePtr> m_queue;
+    bool m_writing = false;
+    bool m_stop_writer = false;
+    WriteStats m_stats;
 };
 
 } // namespace sg
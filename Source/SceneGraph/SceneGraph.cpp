@@ -1214,6 +1214,11 @@ bool Scene::deserialize(deserializer& d)
     sg::read(d, handle);
     d.setPointer(handle, this);
 
+    // SharedVector will reference mapped memory directly
+    auto& stream = d.getStream();
+    if (typeid(stream) == typeid(mu::MappedStream))
+        data_holder = static_cast<mu::MappedStream&>(stream).getFile();
+
     EachMember(sgRead)
 
     if (impl) {
@@ -1268,6 +1273,7 @@ void Scene::close()
     path.clear();
     root_node = nullptr;
     nodes.clear();
+    data_holder.reset();
 }
 
 void Scene::read(double time)
@@ -1278,6 +1284,23 @@ void Scene::read(double time)
         impl->read();
 }
 
+ReadStats Scene::getReadStats()
+{
+    return impl ? impl->getReadStats() : ReadStats();
+}
+
+void Scene::invalidate()
+{
+    if (impl)
+        impl->invalidate();
+}
+
+bool Scene::load(const char* path_)
+{
+    g_current_scene = this;
+    return impl && impl->load(path_);
+}
+
 void Scene::write(double time)
 {
     g_current_scene = const_cast<Scene*>(this);
@@ -1286,6 +1309,18 @@ void Scene::write(double time)
         impl->write();
 }
 
+bool Scene::checkpoint()
+{
+    if (impl)
+        return impl->checkpoint();
+    return false;
+}
+
+WriteStats Scene::getWriteStats()
+{
+    return impl ? impl->getWriteStats() : WriteStats();
+}
+
 Node* Scene::findNodeByID(uint32_t id)
 {
     if (id == 0)
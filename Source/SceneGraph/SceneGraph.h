@@ -45,6 +45,44 @@ struct ConvertOptions
     bool operator!=(const ConvertOptions& v) const;
 };
 
+// options for Scene::open(). readers ignore options they don't support.
+struct OpenOptions
+{
+    std::vector<std::string> population_mask; // if not empty, only these paths and their descendants are opened (USD)
+    bool load_payloads = true; // if false, subtrees under payloads are not opened until Scene::load() (USD)
+    int sample_cache_size = 256; // memory budget in MB for decoded samples kept for scrubbing. 0: disabled (Alembic)
+};
+
+// statistics of readers that cache decoded samples
+struct ReadStats
+{
+    size_t cache_size = 0;  // bytes of samples in the cache
+    int cache_hits = 0;
+    int cache_misses = 0;
+    int cache_evictions = 0;
+};
+
+// options for Scene::write(). writers ignore options they don't support.
+struct WriteOptions
+{
+    bool indexed_primvars = false; // weld face-varying attributes and write them as indexed primvars (USD)
+    int max_queued_frames = 2; // frames that can wait for the writer thread. write() blocks while the queue is full. 0: write synchronously (Alembic)
+    bool points_instancing = false; // write instancers as points with per-point prototype index, orientation and scale instead of instanced xforms (Alembic)
+    int clip_frames = 0; // if > 0, time samples are written to clip layers of this many frames that are referred by value clips of the root layer (USD)
+    bool release_mesh_buffers = false; // write() may take over buffers of MeshNode and leave them empty instead of copying. only for callers that rebuild meshes every frame (USD)
+};
+
+// statistics of writers that write on their own thread
+struct WriteStats
+{
+    int queue_depth = 0;       // frames waiting to be written
+    int max_queue_depth = 0;
+    int frames_written = 0;
+    int stall_count = 0;       // times write() waited for the queue to have space
+    double stall_time = 0.0;   // total time write() waited in ms
+    double last_write_time = 0.0; // time spent to write the last frame in ms
+};
+
 
 class Node
 {
@@ -119,6 +157,8 @@ public:
     void* impl = nullptr;
     void* userdata = nullptr;
     bool removed = false;
+    bool updated = true; // false if the last Scene::read() skipped this node because nothing changed
+    bool prototype = false; // part of a prototype of instances (USD). reached only through InstancerNode::protos
 };
 sgSerializable(Node);
 sgDeclPtr(Node);
@@ -371,6 +411,7 @@ public:
     // non-serializable
     RawVector<float> blendshape_weights;
     RawVector<float4x4> joint_matrices;
+    bool topology_updated = true; // false if the last read kept counts and indices of the previous read
 
 };
 sgSerializable(MeshNode);
@@ -508,9 +549,14 @@ public:
     virtual bool open(const char* path) = 0;
     virtual bool create(const char* path) = 0;
     virtual bool save() = 0;
+    virtual bool checkpoint() { return save(); }
     virtual void close() = 0;
     virtual void read() = 0;
+    virtual ReadStats getReadStats() { return {}; }
+    virtual void invalidate() {}
+    virtual bool load(const char* /*path*/) { return false; }
     virtual void write() = 0;
+    virtual WriteStats getWriteStats() { return {}; }
 
     virtual bool isNodeTypeSupported(Node::Type type) = 0;
     virtual Node* createNode(Node* parent, const char* name, Node::Type type) = 0;
@@ -533,8 +579,19 @@ public:
     bool create(const char* path);
     bool save();
     void close();
+    // read() may skip nodes that don't change over time. Node::updated tells whether the node was read.
+    // invalidate() makes the next read() read all nodes (e.g. nodes were modified after read).
     void read(double time);
+    ReadStats getReadStats();
+    void invalidate();
+    // load the subtree at path that is not opened yet (e.g. payloads not loaded by open()) and create its nodes.
+    // new nodes are appended to nodes and read on next read().
+    bool load(const char* path);
+    // writers may write asynchronously. save() and close() wait for pending writes.
+    // checkpoint() flushes samples written so far to the file while writing continues. returns false if not supported (Alembic).
     void write(double time);
+    bool checkpoint();
+    WriteStats getWriteStats();
 
     Node* findNodeByID(uint32_t id);
     Node* findNodeByPath(const std::string& path);
@@ -607,6 +664,9 @@ public:
 
     // non-serializable
     SceneInterfacePtr impl;
+    OpenOptions open_options;
+    WriteOptions write_options;
+    std::shared_ptr<void> data_holder; // keeps memory that nodes' SharedVector refer (e.g. mapped file) alive
 };
 sgSerializable(Scene);
 sgDeclPtr(Scene);
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "SceneGraphRemote.h"
+#include "sgContainer.h"
 #include "sgUtils.h"
 
 namespace sg {
@@ -87,7 +88,7 @@ private:
     std::string m_exe_path;
     std::string m_usd_path;
     std::shared_ptr<mu::PipeStream> m_pipe;
-    RawVector<char> m_scene_buffer;
+    SceneContainer m_container;
 };
 
 
@@ -102,28 +103,6 @@ USDScenePipe::~USDScenePipe()
 {
 }
 
-static void CopyStream(RawVector<char>& dst, std::iostream& src)
-{
-    const int len = 1024 * 1024;
-    if (dst.size() < len)
-        dst.resize_discard(len);
-
-    size_t pos = 0;
-    size_t space = dst.size();
-    for (;;) {
-        src.read(dst.data() + pos, space);
-        if ((size_t)src.gcount() != space) {
-            dst.resize(pos + (size_t)src.gcount());
-            break;
-        }
-        else {
-            pos = dst.size();
-            dst.resize(dst.size() * 2);
-            space = dst.size() - pos;
-        }
-    }
-}
-
 bool USDScenePipe::open(const char* path)
 {
     close();
@@ -131,17 +110,14 @@ bool USDScenePipe::open(const char* path)
     m_usd_path = path;
     m_pipe.reset(new mu::PipeStream());
     std::string commnd = m_exe_path;
-    commnd += " -hide -tree \"";
+    commnd += " -hide -container -tree \"";
     commnd += m_usd_path;
     commnd += "\"";
     if (m_pipe->open(commnd.c_str(), std::ios::in | std::ios::binary)) {
-        CopyStream(m_scene_buffer, *m_pipe);
+        // node table only. payloads are loaded on demand via m_container.
+        bool ret = m_container.open(*m_scene, *m_pipe);
         m_pipe.reset();
-
-        mu::MemoryStream stream(m_scene_buffer);
-        sg::deserializer des(stream);
-        m_scene->deserialize(des);
-        return !m_scene->nodes.empty();
+        return ret && !m_scene->nodes.empty();
     }
     else {
         m_pipe.reset();
@@ -156,7 +132,7 @@ bool USDScenePipe::create(const char* path)
     m_usd_path = path;
     m_pipe.reset(new mu::PipeStream());
     std::string commnd = m_exe_path;
-    commnd += " -hide -export \"";
+    commnd += " -hide -container -export \"";
     commnd += path;
     commnd += "\"";
     if (!m_pipe->open(commnd.c_str(), std::ios::out | std::ios::binary)) {
@@ -174,6 +150,7 @@ bool USDScenePipe::save()
 void USDScenePipe::close()
 {
     m_pipe.reset();
+    m_container.close();
 }
 
 void USDScenePipe::read()
@@ -186,23 +163,20 @@ void USDScenePipe::read()
         sprintf(buf, " -time %lf", m_scene->time_current);
         commnd += buf;
     }
-    commnd += " -hide";
+    commnd += " -hide -container";
     commnd += " \"";
     commnd += m_usd_path;
     commnd += "\"";
     if (m_pipe->open(commnd.c_str(), std::ios::in | std::ios::binary)) {
-        CopyStream(m_scene_buffer, *m_pipe);
-        mu::MemoryStream stream(m_scene_buffer);
-        sg::deserializer des(stream);
-        m_scene->deserialize(des);
+        // payloads are decoded while receiving subsequent ones
+        m_container.open(*m_scene, *m_pipe, true);
     }
     m_pipe.reset();
 }
 
 void USDScenePipe::write()
 {
-    sg::serializer ser(*m_pipe);
-    m_scene->serialize(ser);
+    SceneContainer::write(*m_pipe, *m_scene);
 }
 
 bool USDScenePipe::isNodeTypeSupported(Node::Type /*type*/)
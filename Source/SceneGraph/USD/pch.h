@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <functional>
 #include <memory>
 #include <sstream>
@@ -28,6 +29,7 @@
 #pragma warning(disable:4244 267)
 #include <pxr/base/plug/registry.h>
 #include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usd/clipsAPI.h>
 #include <pxr/usd/usdGeom/xform.h>
 #include <pxr/usd/usdGeom/camera.h>
 #include <pxr/usd/usdGeom/mesh.h>
@@ -40,8 +42,11 @@
 #include <pxr/usd/usdSkel/cache.h>
 #include <pxr/usd/usdSkel/animation.h>
 #include <pxr/usd/usdSkel/blendShape.h>
+#include <pxr/usd/usdSkel/bindingAPI.h>
 #include <pxr/usd/usdShade/material.h>
 #include <pxr/usd/usdShade/shader.h>
 #include <pxr/usd/usdShade/materialBindingAPI.h>
+#include <tbb/flow_graph.h>
+#include <tbb/parallel_for.h>
 #pragma warning(pop)
 PXR_NAMESPACE_USING_DIRECTIVE;
@@ -9,6 +9,7 @@
 #include <functional>
 #include "../SceneGraph.h"
 #include "../SceneGraphRemote.h"
+#include "../sgContainer.h"
 
 using namespace sg;
 
@@ -27,6 +28,7 @@ int main(int argc, char* argv[])
     bool mode_export = false;
     bool mode_test = false;
     bool mode_header= false;
+    bool mode_container = false;
 #ifdef mqusdDebug
     bool mode_debug = false;
 #endif
@@ -39,6 +41,8 @@ int main(int argc, char* argv[])
                 mode_export = true;
             if (strcmp(argv[ai], "-tree") == 0)
                 mode_header = true;
+            if (strcmp(argv[ai], "-container") == 0)
+                mode_container = true;
             if (strcmp(argv[ai], "-test") == 0)
                 mode_test = true;
             if (strcmp(argv[ai], "-time") == 0)
@@ -70,6 +74,7 @@ int main(int argc, char* argv[])
             "    -version: output version info.\n"
             "    -export: export mode. default is import.\n"
             "    -tree: construct node tree but don't read data.\n"
+            "    -container: input/output sectioned container (sg::SceneContainer) instead of plain serialized data.\n"
             "    -test: test to open usd.\n"
             "    -time time_in_seconds\n"
             "    -file path_to_inout_file\n"
@@ -110,7 +115,7 @@ int main(int argc, char* argv[])
 
             scene = sg::CreateUSDScene();
             if (scene->create(dst_usd.c_str())) {
-                std::fstream f(dst_bin, std::ios::in | std::ios::binary);
+                mu::MappedStream f(dst_bin.c_str());
                 sg::deserializer s(f);
                 scene->deserialize(s);
                 scene->write(scene->time_current);
@@ -124,14 +129,25 @@ int main(int argc, char* argv[])
             if (!scene->create(usd_path.c_str()))
                 return 1;
 
+            auto input = [&](std::istream& is) {
+                if (mode_container) {
+                    sg::SceneContainer container;
+                    container.open(*scene, is, true);
+                }
+                else {
+                    sg::deserializer d(is);
+                    scene->deserialize(d);
+                }
+            };
             if (!file_path.empty()) {
-                std::fstream f(file_path.c_str(), std::ios::in | std::ios::binary);
-                sg::deserializer d(f);
-                scene->deserialize(d);
+                // map the file and let the scene reference it directly (no copy)
+                mu::MappedStream f(file_path.c_str());
+                if (!f)
+                    return 1;
+                input(f);
             }
             else {
-                sg::deserializer d(std::cin);
-                scene->deserialize(d);
+                input(std::cin);
             }
             scene->write(scene->time_current);
             scene->save();
@@ -147,14 +163,21 @@ int main(int argc, char* argv[])
         if (!mode_header)
             scene->read(time);
 
+        auto output = [&](std::ostream& os) {
+            if (mode_container) {
+                sg::SceneContainer::write(os, *scene);
+            }
+            else {
+                sg::serializer s(os);
+                scene->serialize(s);
+            }
+        };
         if (!file_path.empty()) {
             std::fstream of(file_path.c_str(), std::ios::out | std::ios::binary);
-            sg::serializer s(of);
-            scene->serialize(s);
+            output(of);
         }
         else {
-            sg::serializer s(std::cout);
-            scene->serialize(s);
+            output(std::cout);
         }
     }
     return 0;
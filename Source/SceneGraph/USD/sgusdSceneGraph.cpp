@@ -42,7 +42,47 @@ void USDNode::padSample(const UsdAttribute& attr, UsdTimeCode t, const T& defaul
         return;
     auto prev = m_scene->getPrevTime();
     if (t != prev)
-        attr.Set(default_sample, prev);
+        setSample(attr, default_sample, prev);
+}
+
+template<class T>
+void USDNode::setSample(const UsdAttribute& attr, const T& v, UsdTimeCode t)
+{
+    // write time samples directly to the layer if the spec exists (or to the current clip layer).
+    // this skips value resolution and validation of UsdAttribute::Set().
+    if (!t.IsDefault()) {
+        if (auto layer = m_scene->getSampleLayer(attr)) {
+            layer->SetTimeSample(attr.GetPath(), t.GetValue(), v);
+            return;
+        }
+    }
+    attr.Set(v, t);
+}
+
+template<class T>
+void USDNode::setSampleIfChanged(const UsdAttribute& attr, const T& v, HeldSample<T>& prev, UsdTimeCode t)
+{
+    if (t.IsDefault()) {
+        setSample(attr, v, t);
+        return;
+    }
+    // a clip holds its last sample until the next clip begins. each clip needs its own first sample.
+    int clip = m_scene->getClipIndex();
+    if (prev.valid && prev.value == v && prev.clip == clip) {
+        prev.time = t;
+        prev.held = true;
+        return;
+    }
+
+    // close the held range. otherwise the value would be interpolated toward v over the range.
+    if (prev.held && prev.clip == clip)
+        setSample(attr, prev.value, prev.time);
+    setSample(attr, v, t);
+    prev.value = v;
+    prev.time = t;
+    prev.valid = true;
+    prev.held = false;
+    prev.clip = clip;
 }
 
 void USDNode::beforeRead()
@@ -57,17 +97,41 @@ void USDNode::read(UsdTimeCode t)
         GetBinary(m_attr_display_name, dst.display_name, t);
 }
 
+void USDNode::getReadDependencies(std::vector<USDNode*>& dst)
+{
+    // visibility and global matrix are inherited from parent
+    if (m_parent)
+        dst.push_back(m_parent);
+}
+
+bool USDNode::isTimeVarying() const
+{
+    return m_attr_display_name && m_attr_display_name.ValueMightBeTimeVarying();
+}
+
 void USDNode::beforeWrite()
 {
 }
 
-void USDNode::write(UsdTimeCode t)
+void USDNode::prepareWrite(UsdTimeCode /*t*/)
 {
     const auto& src = *getNode();
     if (!m_attr_display_name && !src.display_name.empty() && src.display_name != m_prim.GetName().GetText())
         m_attr_display_name = m_prim.CreateAttribute(sgusdAttrDisplayName, SdfValueTypeNames->String, false);
-    if (m_attr_display_name)
+}
+
+void USDNode::prepareSample(UsdTimeCode /*t*/)
+{
+}
+
+void USDNode::write(UsdTimeCode t)
+{
+    const auto& src = *getNode();
+    // string is not interpolated. no need to close the held range.
+    if (m_attr_display_name && (m_write_count == 1 || src.display_name != m_display_name)) {
         SetBinary(m_attr_display_name, src.display_name, t);
+        m_display_name = src.display_name;
+    }
 }
 
 void USDNode::setNode(Node* node)
@@ -93,7 +157,8 @@ std::string USDNode::makeUniqueName(const std::string& name) const
             if (n == c->getName())
                 return false;
         }
-        return true;
+        // prims that have no corresponding node (e.g. SkelAnimation created on write)
+        return !m_prim.GetChild(TfToken(n));
     });
 }
 
@@ -122,29 +187,37 @@ USDXformNode::USDXformNode(Node* n, UsdPrim prim)
     m_xform = UsdGeomXformable(prim);
 }
 
+void USDXformNode::beforeRead()
+{
+    super::beforeRead();
+    m_xf_query = UsdGeomXformable::XformQuery(m_xform);
+    m_query_visibility = m_xform.GetVisibilityAttr();
+    m_visibility = UsdGeomTokens->inherited;
+}
+
 void USDXformNode::read(UsdTimeCode t)
 {
     super::read(t);
     auto& dst = *getNode<XformNode>();
 
     // visibility
-    TfToken vis;
-    if (m_xform.GetVisibilityAttr().Get(&vis, t)) {
-        if (vis == UsdGeomTokens->inherited) {
-            if (auto px = dst.parent->cast<XformNode>())
-                dst.visibility = px->visibility;
-            else
-                dst.visibility = true;
-        }
+    // note: visible objects may be written with empty token
+    m_query_visibility.fetch(m_visibility, t);
+    if (m_visibility == UsdGeomTokens->inherited) {
+        if (auto px = dst.parent->cast<XformNode>())
+            dst.visibility = px->visibility;
         else
-            dst.visibility = vis != UsdGeomTokens->invisible;
+            dst.visibility = true;
     }
+    else
+        dst.visibility = m_visibility != UsdGeomTokens->invisible;
 
     // transform
-    GfMatrix4d mat;
-    bool reset_stack = false;
-    m_xform.GetLocalTransformation(&mat, &reset_stack, t);
-    dst.local_matrix.assign((double4x4&)mat);
+    if (!m_xf_fetched || m_xf_query.TransformMightBeTimeVarying()) {
+        m_xf_fetched = true;
+        m_xf_query.GetLocalTransformation(&m_local_matrix, t);
+    }
+    dst.local_matrix.assign((double4x4&)m_local_matrix);
 
     if (dst.parent_xform)
         dst.global_matrix = dst.local_matrix * dst.parent_xform->global_matrix;
@@ -152,25 +225,43 @@ void USDXformNode::read(UsdTimeCode t)
         dst.global_matrix = dst.local_matrix;
 }
 
+bool USDXformNode::isTimeVarying() const
+{
+    return super::isTimeVarying() ||
+        m_query_visibility.isTimeVarying() ||
+        m_xf_query.TransformMightBeTimeVarying();
+}
+
+void USDXformNode::beforeWrite()
+{
+    super::beforeWrite();
+    m_xform.CreateVisibilityAttr();
+}
+
+void USDXformNode::prepareWrite(UsdTimeCode t)
+{
+    super::prepareWrite(t);
+    const auto& src = *getNode<XformNode>();
+
+    if (src.local_matrix != float4x4::identity() && m_xf_ops.empty())
+        m_xf_ops.push_back(m_xform.AddTransformOp());
+}
+
 void USDXformNode::write(UsdTimeCode t)
 {
     super::write(t);
     const auto& src = *getNode<XformNode>();
 
     // visibility
-    m_xform.GetVisibilityAttr().Set(src.visibility ? TfToken() : UsdGeomTokens->invisible, t);
+    setSampleIfChanged(m_xform.GetVisibilityAttr(), src.visibility ? TfToken() : UsdGeomTokens->invisible, m_held_visibility, t);
 
     // transform
-    if (src.local_matrix != float4x4::identity()) {
-        if (m_xf_ops.empty()) {
-            m_xf_ops.push_back(m_xform.AddTransformOp());
-        }
-
+    if (src.local_matrix != float4x4::identity() || m_held_matrix.valid) {
         auto& op = m_xf_ops[0];
         if (op.GetOpType() == UsdGeomXformOp::TypeTransform) {
             double4x4 data;
             data.assign(src.local_matrix);
-            op.Set((const GfMatrix4d&)data, t);
+            setSampleIfChanged(op.GetAttr(), (const GfMatrix4d&)data, m_held_matrix, t);
         }
     }
 }
@@ -208,6 +299,20 @@ void USDMeshNode::beforeRead()
     m_attr_joint_weights    = m_prim.GetAttribute(UsdSkelTokens->primvarsSkelJointWeights);
     m_attr_bind_transform   = m_prim.GetAttribute(UsdSkelTokens->primvarsSkelGeomBindTransform);
 
+    // classify attributes
+    m_query_counts  = m_mesh.GetFaceVertexCountsAttr();
+    m_query_indices = m_mesh.GetFaceVertexIndicesAttr();
+    m_query_points  = m_mesh.GetPointsAttr();
+    m_query_normals = m_mesh.GetNormalsAttr();
+    m_query_st      = m_pv_st;
+    m_query_colors  = m_pv_colors;
+    if (m_attr_joint_indices && m_attr_joint_weights) {
+        m_query_joint_indices   = m_attr_joint_indices;
+        m_query_joint_weights   = m_attr_joint_weights;
+        m_query_bind_transform  = m_attr_bind_transform;
+        m_attr_joint_indices.GetMetadata(UsdGeomTokens->elementSize, &m_joints_per_vertex);
+    }
+
     // resolve blendshape/targets
     if (m_attr_bs_ids) {
         VtArray<TfToken> bs_ids;
@@ -252,6 +357,9 @@ void USDMeshNode::beforeRead()
                 dst.skeleton = m_skeleton->getNode<SkeletonNode>();
         }
     }
+    // blendshape weights may be on the animation of the skeleton
+    if (!m_animation && m_skeleton)
+        m_animation = m_skeleton->findAnimationSource();
     if (dst.skeleton) {
         // resolve joints
         if (m_attr_joints) {
@@ -284,6 +392,7 @@ void USDMeshNode::beforeRead()
         auto subsets = mbapi.GetMaterialBindSubsets();
         transform_container(m_isubsets, subsets, [this, &mbapi](SubsetData& data, UsdGeomSubset& subset) {
             data.subset = subset;
+            data.query = subset.GetIndicesAttr();
             data.dst = std::make_shared<FaceSet>();
             if (auto mat = UsdShadeMaterialBindingAPI(subset).ComputeBoundMaterial())
                 data.dst->material = m_scene->findNode<MaterialNode>(mat.GetPath().GetString());
@@ -296,14 +405,18 @@ void USDMeshNode::read(UsdTimeCode t)
     super::read(t);
     auto& dst = *getNode<MeshNode>();
 
+    // samples of time-invariant attributes are kept in sample holders and shared again every frame,
+    // because nodes may be modified after read (e.g. Node::convert())
+
     // counts, indices, points
-    m_mesh.GetFaceVertexCountsAttr().Get(&m_counts, t);
+    bool topology_updated = m_query_counts.fetch(m_counts, t);
     dst.counts.share(m_counts.cdata(), m_counts.size());
 
-    m_mesh.GetFaceVertexIndicesAttr().Get(&m_indices, t);
+    topology_updated |= m_query_indices.fetch(m_indices, t);
     dst.indices.share(m_indices.cdata(), m_indices.size());
+    dst.topology_updated = topology_updated;
 
-    m_mesh.GetPointsAttr().Get(&m_points, t);
+    m_query_points.fetch(m_points, t);
     dst.points.share((float3*)m_points.cdata(), m_points.size());
 
 
@@ -325,18 +438,18 @@ void USDMeshNode::read(UsdTimeCode t)
     };
 
     // normals
-    m_mesh.GetNormalsAttr().Get(&m_normals, t);
+    m_query_normals.fetch(m_normals, t);
     flatten_primvar(dst.normals, m_normals);
 
     // uv
-    if (m_pv_st) {
-        m_pv_st.ComputeFlattened(&m_uvs, t);
+    if (m_query_st) {
+        m_query_st.fetchFlattened(m_uvs, t);
         flatten_primvar(dst.uvs, m_uvs);
     }
 
     // colors
-    if (m_pv_colors) {
-        m_pv_colors.ComputeFlattened(&m_colors, t);
+    if (m_query_colors) {
+        m_query_colors.fetchFlattened(m_colors, t);
         flatten_primvar(dst.colors, m_colors);
     }
 
@@ -355,13 +468,11 @@ void USDMeshNode::read(UsdTimeCode t)
     }
 
     // skel
-    if (m_attr_joint_indices && m_attr_joint_weights) {
-        TfToken interpolation;
-        m_attr_joint_indices.GetMetadata(UsdGeomTokens->elementSize, &dst.joints_per_vertex);
-        m_attr_joint_indices.GetMetadata(UsdGeomTokens->interpolation, &interpolation);
+    if (m_query_joint_indices && m_query_joint_weights) {
+        dst.joints_per_vertex = m_joints_per_vertex;
 
-        m_attr_joint_indices.Get(&m_joint_indices);
-        m_attr_joint_weights.Get(&m_joint_weights);
+        m_query_joint_indices.fetch(m_joint_indices, t);
+        m_query_joint_weights.fetch(m_joint_weights, t);
         if (m_joint_indices.size() == dst.joints_per_vertex) {
             dst.joint_indices.resize_discard(dst.points.size() * dst.joints_per_vertex);
             dst.joint_weights.resize_discard(dst.points.size() * dst.joints_per_vertex);
@@ -374,10 +485,9 @@ void USDMeshNode::read(UsdTimeCode t)
         }
 
 
-        if (m_attr_bind_transform) {
-            GfMatrix4d data;
-            m_attr_bind_transform.Get(&data);
-            dst.bind_transform.assign((double4x4&)data);
+        if (m_query_bind_transform) {
+            m_query_bind_transform.fetch(m_bind_transform, t);
+            dst.bind_transform.assign((double4x4&)m_bind_transform);
         }
     }
 
@@ -385,7 +495,7 @@ void USDMeshNode::read(UsdTimeCode t)
     transform_container(dst.facesets, m_isubsets, [&dst, &t](FaceSetPtr& dfs, SubsetData& data) {
         auto& faces = data.dst->faces;
         if (data.subset) {
-            data.subset.GetIndicesAttr().Get(&data.sample, t);
+            data.query.fetch(data.sample, t);
             faces.share(data.sample.cdata(), data.sample.size());
         }
         else {
@@ -400,6 +510,34 @@ void USDMeshNode::read(UsdTimeCode t)
     dst.validate();
 }
 
+bool USDMeshNode::isTimeVarying() const
+{
+    if (super::isTimeVarying())
+        return true;
+    for (auto* q : { &m_query_counts, &m_query_indices, &m_query_points, &m_query_normals,
+                     &m_query_joint_indices, &m_query_joint_weights, &m_query_bind_transform }) {
+        if (q->isTimeVarying())
+            return true;
+    }
+    if (m_query_st.isTimeVarying() || m_query_colors.isTimeVarying())
+        return true;
+    for (auto& data : m_isubsets) {
+        if (data.query.isTimeVarying())
+            return true;
+    }
+    return false;
+}
+
+void USDMeshNode::getReadDependencies(std::vector<USDNode*>& dst)
+{
+    super::getReadDependencies(dst);
+    // blendshape weights are fetched by animation node. joints are updated by skeleton node.
+    if (m_animation)
+        dst.push_back(m_animation);
+    if (m_skeleton)
+        dst.push_back(m_skeleton);
+}
+
 
 void USDMeshNode::beforeWrite()
 {
@@ -407,11 +545,22 @@ void USDMeshNode::beforeWrite()
 
     // create attributes
     auto pvapi = UsdGeomPrimvarsAPI(m_prim);
-    m_pv_st = pvapi.CreatePrimvar(sgusdAttrST, SdfValueTypeNames->TexCoord2fArray);
-    m_pv_colors = pvapi.CreatePrimvar(sgusdAttrColors, SdfValueTypeNames->Color4fArray);
+    m_pv_st = pvapi.CreatePrimvar(sgusdAttrST, SdfValueTypeNames->TexCoord2fArray, UsdGeomTokens->faceVarying);
+    m_pv_colors = pvapi.CreatePrimvar(sgusdAttrColors, SdfValueTypeNames->Color4fArray, UsdGeomTokens->faceVarying);
+    if (m_scene->getHostScene()->write_options.indexed_primvars) {
+        m_pv_st.CreateIndicesAttr();
+        m_pv_colors.CreateIndicesAttr();
+    }
 
     auto& src = *getNode<MeshNode>();
 
+    // create specs of per-frame attributes. write() writes samples directly to them.
+    m_mesh.CreateFaceVertexCountsAttr();
+    m_mesh.CreateFaceVertexIndicesAttr();
+    m_mesh.CreatePointsAttr();
+    if (!src.normals.empty())
+        m_mesh.CreateNormalsAttr();
+
     // skinning attributes
     if (src.joints_per_vertex > 0) {
         m_attr_joint_indices = m_prim.CreateAttribute(UsdSkelTokens->primvarsSkelJointIndices, SdfValueTypeNames->IntArray, false);
@@ -454,38 +603,44 @@ void USDMeshNode::beforeWrite()
         for(auto* blendshape : src.blendshapes)
             targets.push_back(SdfPath(blendshape->getPath()));
         rel_blendshapes.SetTargets(targets);
+
+        auto binding = UsdSkelBindingAPI::Apply(m_prim);
+        VtArray<TfToken> ids;
+        transform_container(ids, src.blendshapes, [](TfToken& d, auto* blendshape) {
+            d = TfToken(GetUSDNode(blendshape)->getName());
+        });
+        m_attr_bs_ids = binding.CreateBlendShapesAttr();
+
+        // weights are written to the animation of the skeleton this mesh is bound to (directly or by SkelRoot).
+        // the exporter puts meshes with blendshapes under a SkelRoot with a (joint-less if no bones) skeleton.
+        // meshes of other sources that have no skeleton write them to a SkelAnimation bound to the mesh itself.
+        // UsdSkel doesn't resolve animationSource of meshes, so the latter is read back only by this plugin.
+        auto* skel = src.skeleton;
+        if (!skel) {
+            if (auto skel_root = m_node->findParent<SkelRootNode>())
+                skel = skel_root->skeleton;
+        }
+        auto* usd_skel = skel ? GetUSDNode(skel)->cast<USDSkeletonNode>() : nullptr;
+        if (usd_skel)
+            ids = usd_skel->addBlendshapeChannels(&src, ids);
+        m_attr_bs_ids.Set(ids);
+
+        if (!usd_skel && src.blendshape_weights.size() == src.blendshapes.size()) {
+            auto path = m_prim.GetPath().AppendChild(TfToken(makeUniqueName("BlendShapeWeights")));
+            m_bs_animation = UsdSkelAnimation::Define(m_prim.GetStage(), path);
+            m_bs_animation.CreateBlendShapesAttr().Set(ids);
+            m_bs_animation.CreateBlendShapeWeightsAttr();
+            binding.CreateAnimationSourceRel().SetTargets({ path });
+        }
     }
 }
 
-void USDMeshNode::write(UsdTimeCode t)
+void USDMeshNode::prepareWrite(UsdTimeCode t)
 {
-    super::write(t);
+    super::prepareWrite(t);
     auto& src = *getNode<MeshNode>();
 
-    {
-        m_counts.assign(src.counts.begin(), src.counts.end());
-        m_mesh.GetFaceVertexCountsAttr().Set(m_counts, t);
-
-        m_indices.assign(src.indices.begin(), src.indices.end());
-        m_mesh.GetFaceVertexIndicesAttr().Set(m_indices, t);
-
-        m_points.assign((GfVec3f*)src.points.begin(), (GfVec3f*)src.points.end());
-        m_mesh.GetPointsAttr().Set(m_points, t);
-    }
-    if (!src.normals.empty()) {
-        m_normals.assign((GfVec3f*)src.normals.begin(), (GfVec3f*)src.normals.end());
-        m_mesh.GetNormalsAttr().Set(m_normals, t);
-    }
-    if (m_pv_st && !src.uvs.empty()) {
-        m_uvs.assign((GfVec2f*)src.uvs.begin(), (GfVec2f*)src.uvs.end());
-        m_pv_st.Set(m_uvs, t);
-    }
-    if (m_pv_colors && !src.colors.empty()) {
-        m_colors.assign((GfVec4f*)src.colors.begin(), (GfVec4f*)src.colors.end());
-        m_pv_colors.Set(m_colors, t);
-    }
-
-    // subsets
+    // create subsets for newly appeared materials
     for (auto& fs : src.facesets) {
         auto mat = fs->material;
         if (!mat)
@@ -501,11 +656,132 @@ void USDMeshNode::write(UsdTimeCode t)
             // pad empty sample as default value
             padSample(data.subset.GetIndicesAttr(), t, VtArray<int>());
         }
-        data.sample.assign(fs->faces.begin(), fs->faces.end());
     }
+}
+
+void USDMeshNode::prepareSample(UsdTimeCode t)
+{
+    super::prepareSample(t);
+    auto& src = *getNode<MeshNode>();
+
+    // buffers of src are handed over to VtArray (no copy) only if the caller gave them up. otherwise they are copied.
+    auto& opt = m_scene->getHostScene()->write_options;
+    bool release = opt.release_mesh_buffers;
+    MoveToVtArray(m_counts, src.counts, release);
+    MoveToVtArray(m_indices, src.indices, release);
+    MoveToVtArray(m_points, src.points, release);
+
+    bool indexed = opt.indexed_primvars;
+    m_normals = {};
+    if (!src.normals.empty()) {
+        // interpolation is uniform and is decided on the first write. standard readers can't read samples
+        // that don't match it, so it never changes after that.
+        // per-vertex is chosen only for a static (default time) write of smooth normals. time samples are face-varying.
+        bool first = m_normals_interpolation.IsEmpty();
+        bool per_vertex = first ? indexed && t.IsDefault() : m_normals_interpolation == UsdGeomTokens->vertex;
+        SharedVector<float3> vertex_normals;
+        if (per_vertex) {
+            if (src.normals.size() != m_indices.size()) {
+                per_vertex = false;
+            }
+            else if (!mu::ToPerVertex(vertex_normals, src.normals.cdata(), m_indices.cdata(), m_indices.size(), m_points.size())) {
+                if (first) {
+                    per_vertex = false; // not smooth
+                }
+                else {
+                    // already written per-vertex. normals of split vertices are averaged to keep the interpolation.
+                    vertex_normals.resize_zeroclear(m_points.size());
+                    for (size_t i = 0; i < m_indices.size(); ++i)
+                        vertex_normals[m_indices[i]] += src.normals[i];
+                    mu::Normalize(vertex_normals.data(), vertex_normals.size());
+                }
+            }
+        }
+
+        if (per_vertex) {
+            MoveToVtArray(m_normals, vertex_normals);
+            m_normals_interpolation_sample = UsdGeomTokens->vertex;
+        }
+        else if (first || m_normals_interpolation == UsdGeomTokens->faceVarying) {
+            MoveToVtArray(m_normals, src.normals, release);
+            m_normals_interpolation_sample = UsdGeomTokens->faceVarying;
+        }
+        // otherwise normals of this frame can't be written with the interpolation and are skipped
+    }
+
+    // face-varying primvars. identical values are welded and written with indices if indexed.
+    auto convert_primvar = [indexed, release](auto& dst, VtArray<int>& dst_indices, auto& src_values) {
+        using value_t = typename std::remove_reference_t<decltype(src_values)>::value_type;
+        dst = {};
+        if (src_values.empty())
+            return;
+        if (indexed) {
+            SharedVector<value_t> values;
+            SharedVector<int> indices;
+            mu::WeldValues(values, indices, src_values.cdata(), src_values.size());
+            MoveToVtArray(dst, values);
+            MoveToVtArray(dst_indices, indices);
+        }
+        else {
+            MoveToVtArray(dst, src_values, release);
+        }
+    };
+    if (m_pv_st)
+        convert_primvar(m_uvs, m_uv_indices, src.uvs);
+    if (m_pv_colors)
+        convert_primvar(m_colors, m_color_indices, src.colors);
+
+    // blendshape weights
+    if (m_bs_animation && src.blendshape_weights.size() == src.blendshapes.size())
+        m_bs_weights.assign(src.blendshape_weights.begin(), src.blendshape_weights.end());
+
+    // subsets. entries are created by prepareWrite().
+    for (auto& fs : src.facesets) {
+        auto mat = fs->material;
+        if (!mat)
+            continue;
+        MoveToVtArray(m_osubsets[mat->id].sample, fs->faces, release);
+    }
+}
+
+void USDMeshNode::write(UsdTimeCode t)
+{
+    super::write(t);
+    auto& src = *getNode<MeshNode>();
+
+    // samples are converted by prepareSample()
+    setSampleIfChanged(m_mesh.GetFaceVertexCountsAttr(), m_counts, m_held_counts, t);
+    setSampleIfChanged(m_mesh.GetFaceVertexIndicesAttr(), m_indices, m_held_indices, t);
+    setSampleIfChanged(m_mesh.GetPointsAttr(), m_points, m_held_points, t);
+
+    if (!m_normals.empty()) {
+        if (m_normals_interpolation.IsEmpty()) {
+            // interpolation can't be time sampled. set once by the first write.
+            m_mesh.SetNormalsInterpolation(m_normals_interpolation_sample);
+            m_normals_interpolation = m_normals_interpolation_sample;
+        }
+        setSampleIfChanged(m_mesh.GetNormalsAttr(), m_normals, m_held_normals, t);
+    }
+
+    bool indexed = m_scene->getHostScene()->write_options.indexed_primvars;
+    auto write_primvar = [&](UsdGeomPrimvar& pv, auto& values, auto& held, VtArray<int>& indices, HeldSample<VtArray<int>>& held_indices) {
+        if (!pv || values.empty())
+            return;
+        if (indexed)
+            setSampleIfChanged(pv.GetIndicesAttr(), indices, held_indices, t);
+        setSampleIfChanged(pv.GetAttr(), values, held, t);
+    };
+    write_primvar(m_pv_st, m_uvs, m_held_uvs, m_uv_indices, m_held_uv_indices);
+    write_primvar(m_pv_colors, m_colors, m_held_colors, m_color_indices, m_held_color_indices);
+
+    // blendshape weights
+    if (m_bs_animation && src.blendshape_weights.size() == src.blendshapes.size())
+        setSampleIfChanged(m_bs_animation.GetBlendShapeWeightsAttr(), m_bs_weights, m_held_bs_weights, t);
+
+    // subsets
     for (auto& kvp : m_osubsets) {
         auto& data = kvp.second;
-        data.subset.GetIndicesAttr().Set(data.sample, t);
+        setSampleIfChanged(data.subset.GetIndicesAttr(), data.sample, data.held, t);
         data.sample = {};
     }
 }
@@ -627,10 +903,13 @@ void USDSkelRootNode::beforeRead()
                 dst.skeleton = skel;
 
                 // update child meshes
-                eachChildR([usd_skel, skel](USDNode* n) {
+                auto usd_anim = usd_skel->findAnimationSource();
+                eachChildR([usd_skel, skel, usd_anim](USDNode* n) {
                     if (auto usd_mesh = n->cast<USDMeshNode>()) {
                         usd_mesh->m_skeleton = usd_skel;
                         usd_mesh->getNode<MeshNode>()->skeleton = skel;
+                        if (!usd_mesh->m_animation)
+                            usd_mesh->m_animation = usd_anim;
                     }
                 });
             }
@@ -676,6 +955,17 @@ USDSkeletonNode::USDSkeletonNode(Node* n, UsdPrim prim)
 void USDSkeletonNode::beforeRead()
 {
     super::beforeRead();
+
+    m_query_bind_transforms = m_skel.GetBindTransformsAttr();
+    m_query_rest_transforms = m_skel.GetRestTransformsAttr();
+    m_skel_query = m_cache.GetSkelQuery(m_skel);
+    if (m_skel_query) {
+        // without animation, joint transforms are rest transforms
+        if (auto anim = m_skel_query.GetAnimQuery())
+            m_joints_time_varying = anim.JointTransformsMightBeTimeVarying();
+        else
+            m_joints_time_varying = m_query_rest_transforms.isTimeVarying();
+    }
 }
 
 void USDSkeletonNode::read(UsdTimeCode t)
@@ -685,8 +975,8 @@ void USDSkeletonNode::read(UsdTimeCode t)
 
     // bindpose
     {
-        VtArray<GfMatrix4d> data;
-        m_skel.GetBindTransformsAttr().Get(&data);
+        auto& data = m_bind_transforms;
+        m_query_bind_transforms.fetch(data, t);
         size_t n = data.size();
         if (dst.joints.size() == n) {
             for (size_t i = 0; i < n; ++i)
@@ -694,8 +984,8 @@ void USDSkeletonNode::read(UsdTimeCode t)
         }
     }
     {
-        VtArray<GfMatrix4d> data;
-        m_skel.GetRestTransformsAttr().Get(&data);
+        auto& data = m_rest_transforms;
+        m_query_rest_transforms.fetch(data, t);
         size_t n = data.size();
         if (dst.joints.size() == n) {
             for (size_t i = 0; i < n; ++i)
@@ -704,18 +994,30 @@ void USDSkeletonNode::read(UsdTimeCode t)
     }
 
     // update joint matrices
-    if (auto query = m_cache.GetSkelQuery(m_skel)) {
-        VtArray<GfMatrix4d> data;
-        query.ComputeJointLocalTransforms(&data, t);
+    if (m_skel_query) {
+        auto& data = m_joint_transforms;
+        if (!m_joints_fetched || m_joints_time_varying) {
+            m_joints_fetched = true;
+            m_skel_query.ComputeJointLocalTransforms(&data, t);
+        }
         size_t n = data.size();
         if (dst.joints.size() == n) {
             for (size_t i = 0; i < n; ++i)
                 dst.joints[i]->local_matrix.assign((double4x4&)data[i]);
         }
+        // global matrix of skeleton itself may be animated
         dst.updateGlobalMatrices(dst.global_matrix);
     }
 }
 
+bool USDSkeletonNode::isTimeVarying() const
+{
+    return super::isTimeVarying() ||
+        m_query_bind_transforms.isTimeVarying() ||
+        m_query_rest_transforms.isTimeVarying() ||
+        m_joints_time_varying;
+}
+
 void USDSkeletonNode::beforeWrite()
 {
     super::beforeWrite();
@@ -728,6 +1030,15 @@ void USDSkeletonNode::beforeWrite()
             dst = TfToken(EncodeNodePath(joint->path));
         });
         m_skel.GetJointsAttr().Set(data);
+
+        // joint animation. write() writes local matrices of joints to it as TRS.
+        if (njoints > 0) {
+            auto& anim = getAnimation();
+            anim.CreateJointsAttr().Set(data);
+            anim.CreateTranslationsAttr();
+            anim.CreateRotationsAttr();
+            anim.CreateScalesAttr();
+        }
     }
 
     {
@@ -746,10 +1057,115 @@ void USDSkeletonNode::beforeWrite()
     }
 }
 
+void USDSkeletonNode::prepareSample(UsdTimeCode t)
+{
+    super::prepareSample(t);
+    const auto& src = *getNode<SkeletonNode>();
+
+    // blendshape weights of bound meshes
+    if (!m_bs_meshes.empty()) {
+        m_bs_weights.resize(m_bs_channels.size());
+        auto* dst_w = m_bs_weights.data();
+        for (auto& rec : m_bs_meshes) {
+            auto& weights = rec.mesh->blendshape_weights;
+            if (weights.size() == rec.count)
+                std::copy(weights.begin(), weights.end(), dst_w + rec.offset);
+            else
+                std::fill(dst_w + rec.offset, dst_w + rec.offset + rec.count, 0.0f);
+        }
+    }
+
+    size_t njoints = src.joints.size();
+    if (!m_animation || njoints == 0)
+        return;
+
+    m_local_matrices.resize_discard(njoints);
+    for (size_t i = 0; i < njoints; ++i)
+        m_local_matrices[i] = src.joints[i]->local_matrix;
+
+    m_translations.resize(njoints);
+    m_rotations.resize(njoints);
+    m_scales.resize(njoints);
+    m_local_rotations.resize_discard(njoints);
+    m_local_scales.resize_discard(njoints);
+    mu::ExtractTRS(m_local_matrices.cdata(), (float3*)m_translations.data(), m_local_rotations.data(), m_local_scales.data(), njoints);
+
+    auto* dst_r = m_rotations.data();
+    auto* dst_s = m_scales.data();
+    for (size_t i = 0; i < njoints; ++i) {
+        auto& rot = m_local_rotations[i];
+        auto& scale = m_local_scales[i];
+        dst_r[i] = { rot.w, rot.x, rot.y, rot.z };
+        dst_s[i] = { scale.x, scale.y, scale.z };
+    }
+}
+
 void USDSkeletonNode::write(UsdTimeCode t)
 {
     super::write(t);
-    // todo
+    const auto& src = *getNode<SkeletonNode>();
+    if (!m_bs_meshes.empty()) {
+        setSampleIfChanged(m_animation.GetBlendShapeWeightsAttr(), m_bs_weights, m_held_bs_weights, t);
+        m_bs_channels_fixed = true;
+    }
+    if (!m_animation || src.joints.empty())
+        return;
+
+    setSampleIfChanged(m_animation.GetTranslationsAttr(), m_translations, m_held_translations, t);
+    setSampleIfChanged(m_animation.GetRotationsAttr(), m_rotations, m_held_rotations, t);
+    setSampleIfChanged(m_animation.GetScalesAttr(), m_scales, m_held_scales, t);
+}
+
+UsdSkelAnimation& USDSkeletonNode::getAnimation()
+{
+    // meshes may request the animation before beforeWrite() of this node
+    if (!m_animation) {
+        auto path = m_prim.GetPath().AppendChild(TfToken(makeUniqueName("Animation")));
+        m_animation = UsdSkelAnimation::Define(m_prim.GetStage(), path);
+        UsdSkelBindingAPI::Apply(m_prim).CreateAnimationSourceRel().SetTargets({ path });
+    }
+    return m_animation;
+}
+
+VtArray<TfToken> USDSkeletonNode::addBlendshapeChannels(const MeshNode* mesh, const VtArray<TfToken>& names)
+{
+    VtArray<TfToken> ret;
+    ret.reserve(names.size());
+    for (auto& name : names) {
+        // other meshes may have blendshapes with the same name
+        TfToken channel = name;
+        for (int i = 1; std::find(m_bs_channels.begin(), m_bs_channels.end(), channel) != m_bs_channels.end() ||
+            std::find(ret.begin(), ret.end(), channel) != ret.end(); ++i)
+            channel = TfToken(name.GetString() + "_" + std::to_string(i));
+        ret.push_back(channel);
+    }
+
+    if (m_bs_channels_fixed) {
+        // weights have been written. adding channels would make them mismatch with the channel count.
+        // channels of meshes appeared later are not in the animation and their weights stay 0.
+        sgDbgPrint("USDSkeletonNode::addBlendshapeChannels(): blendshapes of %s are not animated\n", mesh->getPath().c_str());
+        return ret;
+    }
+
+    m_bs_meshes.push_back({ mesh, m_bs_channels.size(), ret.size() });
+    for (auto& channel : ret)
+        m_bs_channels.push_back(channel);
+
+    auto& anim = getAnimation();
+    anim.CreateBlendShapesAttr().Set(m_bs_channels);
+    anim.CreateBlendShapeWeightsAttr();
+    return ret;
+}
+
+USDSkelAnimationNode* USDSkeletonNode::findAnimationSource()
+{
+    if (auto rel_anim = m_prim.GetRelationship(UsdSkelTokens->skelAnimationSource)) {
+        SdfPathVector paths;
+        rel_anim.GetTargets(&paths);
+        if (!paths.empty())
+            return m_scene->findNode<USDSkelAnimationNode>(paths.front().GetString());
+    }
+    return nullptr;
 }
 
 
@@ -785,6 +1201,17 @@ void USDSkelAnimationNode::beforeRead()
     }
 }
 
+void USDSkelAnimationNode::read(UsdTimeCode t)
+{
+    super::read(t);
+    getBlendshapeData(t);
+}
+
+bool USDSkelAnimationNode::isTimeVarying() const
+{
+    return super::isTimeVarying() || m_anim.GetBlendShapeWeightsAttr().ValueMightBeTimeVarying();
+}
+
 std::vector<const USDSkelAnimationNode::BlendshapeData*>& USDSkelAnimationNode::getBlendshapeData(UsdTimeCode t)
 {
     if (t != m_prev_read) {
@@ -802,7 +1229,7 @@ std::vector<const USDSkelAnimationNode::BlendshapeData*>& USDSkelAnimationNode::
 
 
 USDInstancerNode::USDInstancerNode(USDNode* parent, UsdPrim prim)
-    : super(parent, prim)
+    : super(parent, prim, false)
 {
     m_instancer = UsdGeomPointInstancer(prim);
     setNode(CreateNode<InstancerNode>(parent, prim));
@@ -819,6 +1246,31 @@ void USDInstancerNode::beforeRead()
     super::beforeRead();
     auto& dst = *getNode<InstancerNode>();
 
+    // instance transforms are time-varying if any of attributes they depend on are
+    m_query_proto_indices = m_instancer.GetProtoIndicesAttr();
+    UsdAttribute transform_attrs[] = {
+        m_instancer.GetProtoIndicesAttr(),
+        m_instancer.GetPositionsAttr(),
+        m_instancer.GetOrientationsAttr(),
+        m_instancer.GetScalesAttr(),
+        m_instancer.GetVelocitiesAttr(),
+        m_instancer.GetAngularVelocitiesAttr(),
+        m_instancer.GetInvisibleIdsAttr(),
+    };
+    m_matrices_time_varying = false;
+    for (auto& attr : transform_attrs) {
+        if (attr && attr.ValueMightBeTimeVarying())
+            m_matrices_time_varying = true;
+    }
+
+    // ComputeInstanceTransformsAtTime() is needed only if velocities, masks or transforms of prototypes are involved.
+    // otherwise instance transforms are composed from positions, orientations and scales in batch.
+    m_compose_matrices =
+        !m_instancer.GetVelocitiesAttr().HasAuthoredValue() &&
+        !m_instancer.GetAngularVelocitiesAttr().HasAuthoredValue() &&
+        !m_instancer.GetInvisibleIdsAttr().HasAuthoredValue() &&
+        !m_prim.HasMetadata(UsdGeomTokens->inactiveIds);
+
     auto rel = m_instancer.GetPrototypesRel();
     if (rel) {
         SdfPathVector paths;
@@ -826,6 +1278,11 @@ void USDInstancerNode::beforeRead()
         for (auto& path : paths) {
             if (auto proto = m_scene->findNode<USDNode>(path.GetString()))
                 dst.protos.push_back(proto->m_node);
+
+            bool reset;
+            UsdGeomXformable xf(m_scene->getStage()->GetPrimAtPath(path));
+            if (xf && !xf.GetOrderedXformOps(&reset).empty())
+                m_compose_matrices = false;
         }
     }
 }
@@ -835,13 +1292,66 @@ void USDInstancerNode::read(UsdTimeCode t)
     super::read(t);
     auto& dst = *getNode<InstancerNode>();
 
-    m_instancer.GetProtoIndicesAttr().Get(&m_proto_indices, t);
+    m_query_proto_indices.fetch(m_proto_indices, t);
     dst.proto_indices.share(m_proto_indices.cdata(), m_proto_indices.size());
 
-    m_instancer.ComputeInstanceTransformsAtTime(&m_matrices, t, t);
-    transform_container(dst.matrices, m_matrices, [](float4x4& d, const GfMatrix4d& s) {
-        d.assign((double4x4&)s);
-    });
+    if (!m_matrices_fetched || m_matrices_time_varying) {
+        m_matrices_fetched = true;
+        m_matrices_composed = m_compose_matrices && composeMatrices(t);
+        if (!m_matrices_composed)
+            m_instancer.ComputeInstanceTransformsAtTime(&m_matrices, t, t);
+    }
+    if (m_matrices_composed) {
+        dst.matrices.share(m_composed_matrices.cdata(), m_composed_matrices.size());
+    }
+    else {
+        transform_container(dst.matrices, m_matrices, [](float4x4& d, const GfMatrix4d& s) {
+            d.assign((double4x4&)s);
+        });
+    }
+}
+
+bool USDInstancerNode::composeMatrices(UsdTimeCode t)
+{
+    m_instancer.GetPositionsAttr().Get(&m_positions, t);
+    m_instancer.GetOrientationsAttr().Get(&m_orientations, t);
+    m_instancer.GetScalesAttr().Get(&m_scales, t);
+
+    // fall back to ComputeInstanceTransformsAtTime() to handle invalid data in the same way
+    size_t n = m_proto_indices.size();
+    if (m_positions.size() != n ||
+        (!m_orientations.empty() && m_orientations.size() != n) ||
+        (!m_scales.empty() && m_scales.size() != n))
+        return false;
+
+    m_rotations.resize_discard(n);
+    if (m_orientations.empty()) {
+        std::fill(m_rotations.begin(), m_rotations.end(), quatf::identity());
+    }
+    else {
+        // mu::transform() takes the conjugate of what mu::extract_trs() returns (= orientations of USD)
+        for (size_t i = 0; i < n; ++i) {
+            auto& q = m_orientations[i];
+            auto& im = q.GetImaginary();
+            m_rotations[i] = { -im[0], -im[1], -im[2], q.GetReal() };
+        }
+    }
+
+    const float3* scales = (const float3*)m_scales.cdata();
+    if (m_scales.empty()) {
+        m_scales_tmp.resize_discard(n);
+        std::fill(m_scales_tmp.begin(), m_scales_tmp.end(), float3::one());
+        scales = m_scales_tmp.cdata();
+    }
+
+    m_composed_matrices.resize_discard(n);
+    mu::ComposeTRS((const float3*)m_positions.cdata(), m_rotations.cdata(), scales, m_composed_matrices.data(), n);
+    return true;
+}
+
+bool USDInstancerNode::isTimeVarying() const
+{
+    return super::isTimeVarying() || m_query_proto_indices.isTimeVarying() || m_matrices_time_varying;
 }
 
 void USDInstancerNode::beforeWrite()
@@ -849,6 +1359,11 @@ void USDInstancerNode::beforeWrite()
     super::beforeWrite();
     const auto& src = *getNode<InstancerNode>();
 
+    m_instancer.CreateProtoIndicesAttr();
+    m_instancer.CreatePositionsAttr();
+    m_instancer.CreateOrientationsAttr();
+    m_instancer.CreateScalesAttr();
+
     auto rel = m_instancer.CreatePrototypesRel();
     if (rel) {
         SdfPathVector paths;
@@ -858,29 +1373,82 @@ void USDInstancerNode::beforeWrite()
     }
 }
 
-void USDInstancerNode::write(UsdTimeCode t)
+void USDInstancerNode::prepareSample(UsdTimeCode t)
 {
-    super::write(t);
+    super::prepareSample(t);
     const auto& src = *getNode<InstancerNode>();
 
     m_proto_indices.assign(src.proto_indices.begin(), src.proto_indices.end());
-    m_instancer.GetProtoIndicesAttr().Set(m_proto_indices, t);
 
     size_t n = src.matrices.size();
     m_positions.resize(n);
     m_orientations.resize(n);
     m_scales.resize(n);
+    m_rotations.resize_discard(n);
+    mu::ExtractTRS(src.matrices.cdata(), (float3*)m_positions.data(), m_rotations.data(), (float3*)m_scales.data(), n);
+
+    auto* dst_r = m_orientations.data();
     for (size_t i = 0; i < n; ++i) {
-        float3 t; quatf r; float3 s;
-        mu::extract_trs(src.matrices[i], t, r, s);
-        m_positions[i] = { t.x, t.y, t.z };
-        m_orientations[i] = { r.w, r.x, r.y, r.z };
-        m_positions[i] = { s.x, s.y, s.z };
+        auto& r = m_rotations[i];
+        dst_r[i] = GfQuath(r.w, r.x, r.y, r.z);
     }
+}
+
+void USDInstancerNode::write(UsdTimeCode t)
+{
+    super::write(t);
+
+    setSampleIfChanged(m_instancer.GetProtoIndicesAttr(), m_proto_indices, m_held_proto_indices, t);
+    setSampleIfChanged(m_instancer.GetPositionsAttr(), m_positions, m_held_positions, t);
+    setSampleIfChanged(m_instancer.GetOrientationsAttr(), m_orientations, m_held_orientations, t);
+    setSampleIfChanged(m_instancer.GetScalesAttr(), m_scales, m_held_scales, t);
+}
+
+
+
+USDInstanceNode::USDInstanceNode(USDNode* parent, UsdPrim prim)
+    : super(parent, prim, false)
+{
+    setNode(CreateNode<InstancerNode>(parent, prim));
+}
+
+void USDInstanceNode::beforeRead()
+{
+    super::beforeRead();
+
+    // prototypes are constructed after the scene tree. resolve it here.
+    resolvePrototype();
+}
 
-    m_instancer.GetPositionsAttr().Set(m_positions, t);
-    m_instancer.GetOrientationsAttr().Set(m_orientations, t);
-    m_instancer.GetScalesAttr().Set(m_scales, t);
+void USDInstanceNode::resolvePrototype()
+{
+    m_prototype = nullptr;
+#if PXR_VERSION >= 2011
+    auto proto = m_prim.GetPrototype();
+#else
+    auto proto = m_prim.GetMaster();
+#endif
+    if (proto)
+        m_prototype = m_scene->findUSDNodeImpl(proto.GetPath().GetString());
+}
+
+void USDInstanceNode::read(UsdTimeCode t)
+{
+    super::read(t);
+    auto& dst = *getNode<InstancerNode>();
+
+    // the transform of the instance is local_matrix. the prototype is placed at its origin.
+    // meshes gathered from the previous prototype are no longer valid if it has been reassigned.
+    if (dst.protos.size() != 1 || !m_prototype || dst.protos[0] != m_prototype->m_node)
+        dst.proto_records.clear();
+    dst.protos.clear();
+    dst.proto_indices.clear();
+    dst.matrices.clear();
+    if (m_prototype) {
+        dst.protos.push_back(m_prototype->m_node);
+        dst.proto_indices.push_back(0);
+        dst.matrices.push_back(float4x4::identity());
+    }
 }
 
 
@@ -978,6 +1546,19 @@ void USDMaterialNode::read(UsdTimeCode t)
     get_texture(dst.bump_texture, m_tex_bump);
 }
 
+bool USDMaterialNode::isTimeVarying() const
+{
+    if (super::isTimeVarying())
+        return true;
+    // textures are read at default time
+    for (auto* in : { &m_in_use_vertex_color, &m_in_double_sided, &m_in_diffuse_color, &m_in_diffuse, &m_in_opacity,
+                      &m_in_roughness, &m_in_ambient_color, &m_in_specular_color, &m_in_emissive_color }) {
+        if (*in && in->GetAttr().ValueMightBeTimeVarying())
+            return true;
+    }
+    return false;
+}
+
 void USDMaterialNode::beforeWrite()
 {
     super::beforeWrite();
@@ -1115,7 +1696,17 @@ USDScene::~USDScene()
 bool USDScene::open(const char* path_)
 {
     m_scene->path = path_;
-    m_stage = UsdStage::Open(path_);
+    auto& opt = m_scene->open_options;
+    auto load = opt.load_payloads ? UsdStage::LoadAll : UsdStage::LoadNone;
+    if (!opt.population_mask.empty()) {
+        UsdStagePopulationMask mask;
+        for (auto& path : opt.population_mask)
+            mask.Add(SdfPath(path));
+        m_stage = UsdStage::OpenMasked(path_, mask, load);
+    }
+    else {
+        m_stage = UsdStage::Open(path_, load);
+    }
     if (!m_stage)
         return false;
 
@@ -1126,14 +1717,11 @@ bool USDScene::open(const char* path_)
     m_scene->time_start = m_stage->GetStartTimeCode() / m_frame_rate;
     m_scene->time_end = m_stage->GetEndTimeCode() / m_frame_rate;
 
-    //    auto masters = m_stage->GetMasters();
-    //    for (auto& m : masters) {
-    //        m_masters.push_back(createSchemaRecursive(nullptr, m));
-    //}
     auto root = m_stage->GetPseudoRoot();
     if (root.IsValid()) {
         m_root = new USDRootNode(root);
         constructTree(m_root);
+        constructPrototypes();
     }
     for (auto& node : m_nodes)
         node->beforeRead();
@@ -1153,6 +1741,7 @@ bool USDScene::create(const char* path_)
     if (m_stage) {
         g_current_scene = this;
 
+        m_layer = m_stage->GetEditTarget().GetLayer();
         m_frame_rate = m_scene->frame_rate;
         m_stage->SetFramesPerSecond(m_scene->frame_rate);
 
@@ -1168,17 +1757,98 @@ bool USDScene::create(const char* path_)
 bool USDScene::save()
 {
     if (m_stage) {
+        if (m_clip_layer) {
+            m_clip_layer->Save();
+            updateClips(m_clip_paths.size());
+            m_manifest_layer->Save();
+        }
         return m_stage->GetRootLayer()->Save();
     }
     return false;
 }
 
+// "dir/name.ext" -> "name.<suffix>.ext"
+static std::string MakeClipFilename(const std::string& path, const char* suffix)
+{
+    auto pos = path.find_last_of('.');
+    auto ext = pos != std::string::npos ? path.substr(pos) : std::string(".usd");
+    return mu::GetFilename_NoExtension(path.c_str()) + "." + suffix + ext;
+}
+
+void USDScene::beginClip(UsdTimeCode t)
+{
+    if (m_clip_layer)
+        endClip();
+
+    auto& path = m_scene->path;
+    auto dir = mu::GetDirectory(path.c_str());
+    if (!dir.empty())
+        dir += "/";
+    auto create_layer = [&](const std::string& filename) {
+        // SdfLayer::CreateNew() will fail if the file already exists
+        auto fullpath = dir + filename;
+        std::remove(fullpath.c_str());
+        return SdfLayer::CreateNew(fullpath);
+    };
+
+    if (!m_manifest_layer)
+        m_manifest_layer = create_layer(MakeClipFilename(path, "manifest"));
+
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "clip%04d", (int)m_clip_paths.size() + 1);
+    auto filename = MakeClipFilename(path, suffix);
+    m_clip_layer = create_layer(filename);
+    if (m_clip_layer) {
+        m_clip_paths.push_back("./" + filename);
+        m_clip_start_times.push_back(t.GetValue());
+    }
+}
+
+void USDScene::endClip()
+{
+    // the finished clip will not be modified anymore. release it and let the root layer refer it.
+    m_clip_layer->Save();
+    m_clip_layer = {};
+    updateClips(m_clip_paths.size());
+    m_manifest_layer->Save();
+    m_stage->GetRootLayer()->Save();
+}
+
+void USDScene::updateClips(size_t num_clips)
+{
+    if (num_clips == 0 || !m_manifest_layer)
+        return;
+
+    VtArray<SdfAssetPath> asset_paths;
+    VtVec2dArray active, times;
+    for (size_t i = 0; i < num_clips; ++i) {
+        double start = m_clip_start_times[i];
+        asset_paths.push_back(SdfAssetPath(m_clip_paths[i]));
+        active.push_back(GfVec2d(start, (double)i));
+        times.push_back(GfVec2d(start, start));
+    }
+    double end = m_max_time * m_frame_rate;
+    if (end > times.back()[0])
+        times.push_back(GfVec2d(end, end));
+
+    auto manifest = SdfAssetPath("./" + mu::GetFilename(m_manifest_layer->GetRealPath().c_str()));
+    for (auto prim : m_stage->GetPseudoRoot().GetChildren()) {
+        UsdClipsAPI clips(prim);
+        clips.SetClipAssetPaths(asset_paths);
+        clips.SetClipPrimPath(prim.GetPath().GetString());
+        clips.SetClipActive(active);
+        clips.SetClipTimes(times);
+        clips.SetClipManifestAssetPath(manifest);
+    }
+}
+
 void USDScene::registerNode(USDNode* n)
 {
     if (n) {
         m_nodes.push_back(USDNodePtr(n));
         m_node_table[n->getPath()] = n;
         m_scene->registerNode(n->m_node);
+        clearReadGraphs();
     }
 }
 
@@ -1188,43 +1858,221 @@ void USDScene::constructTree(USDNode* n)
     PrintPrim(n->m_prim);
 #endif
     registerNode(n);
+    constructChildren(n);
+}
+
+void USDScene::constructChildren(USDNode* n)
+{
+    // if n already has children, this is called by load(). existing ones are not constructed again,
+    // but payloads loaded under them must be.
+    bool has_children = !n->m_children.empty();
 
     auto& prim = n->m_prim;
     auto children = prim.GetChildren();
     for (auto cprim : children) {
-        USDNode* c = nullptr;
+        // subtrees under unloaded payloads are constructed by load()
+        if (!cprim.IsLoaded())
+            continue;
 
-        // note: SkelAnimation is hidden on mqusdSceneGraph.h side
-        if (!c) {
-            UsdSkelAnimation schema(cprim);
-            if (schema)
-                c = new USDSkelAnimationNode(n, cprim);
-        }
-        if (!c) {
-            UsdShadeShader schema(cprim);
-            if (schema)
-                c = new USDShaderNode(n, cprim);
+        if (has_children) {
+            if (auto existing = findUSDNodeImpl(cprim.GetPath().GetString())) {
+                constructChildren(existing);
+                continue;
+            }
         }
+        USDNode* c = nullptr;
+        if (cprim.IsInstance())
+            c = new USDInstanceNode(n, cprim);
+        else
+            c = findNodeFactory(cprim)(n, cprim);
+        constructTree(c);
+    }
+}
 
-#define Case(E, T)\
-        if (!c) {\
-            T::UsdType schema(cprim);\
-            if (schema)\
-                c = new T(n, cprim);\
+void USDScene::constructPrototypes()
+{
+    // prototypes of instances are not children of any prim. construct them under the root.
+    // each of them is wrapped once and shared by USDInstanceNodes.
+#if PXR_VERSION >= 2011
+    auto prototypes = m_stage->GetPrototypes();
+#else
+    auto prototypes = m_stage->GetMasters();
+#endif
+    for (auto& proto : prototypes) {
+        if (findUSDNodeImpl(proto.GetPath().GetString()))
+            continue;
+        auto n = findNodeFactory(proto)(m_root, proto);
+        constructTree(n);
+
+        // keep them out of the scene tree for importers
+        n->m_node->prototype = true;
+        n->m_node->eachChildR([](Node* c) { c->prototype = true; });
+    }
+}
+
+bool USDScene::removeExpiredPrototypes()
+{
+    // prototypes are reassigned when instances are recomposed (e.g. payloads are loaded) and old ones expire.
+    // note: expired prims can't be accessed at all. use paths of Node.
+    auto expired = [](const USDNodePtr& n) { return n->m_node->prototype && !n->m_prim.IsValid(); };
+    if (std::none_of(m_nodes.begin(), m_nodes.end(), expired))
+        return false;
+
+    std::vector<Node*> removed;
+    for (auto& n : m_nodes) {
+        if (expired(n)) {
+            m_node_table.erase(n->m_node->path);
+            removed.push_back(n->m_node);
         }
+    }
+    auto is_removed = [&removed](Node* n) { return std::find(removed.begin(), removed.end(), n) != removed.end(); };
+    erase_if(m_root->m_children, [&](USDNode* n) { return is_removed(n->m_node); });
+    erase_if(m_root->m_node->children, is_removed);
+    erase_if(m_nodes, expired);
+    erase_if(m_scene->nodes, [&](NodePtr& n) { return is_removed(n.get()); });
+    clearReadGraphs();
+    return true;
+}
+
+template<class NodeT>
+static USDNode* CreateUSDNode(USDNode* parent, UsdPrim prim)
+{
+    return new NodeT(parent, prim);
+}
+
+USDScene::NodeFactory USDScene::findNodeFactory(const UsdPrim& prim)
+{
+    if (m_node_factories.empty()) {
+        // note: SkelAnimation is hidden on mqusdSceneGraph.h side
+#define Case(E, T) m_node_factories[TfToken(T::getUsdTypeName())] = &CreateUSDNode<T>;
+        Case(SkelAnimation, USDSkelAnimationNode)
+        Case(Shader, USDShaderNode)
         EachNodeType(Case)
 #undef Case
+    }
+
+    auto type_name = prim.GetTypeName();
+    auto it = m_node_factories.find(type_name);
+    if (it != m_node_factories.end())
+        return it->second;
+
+    // derived types (e.g. Cube is an Xformable). try each schema and cache the result.
+    NodeFactory ret = nullptr;
+#define Case(E, T)\
+    if (!ret) {\
+        T::UsdType schema(prim);\
+        if (schema)\
+            ret = &CreateUSDNode<T>;\
+    }
+    Case(SkelAnimation, USDSkelAnimationNode)
+    Case(Shader, USDShaderNode)
+    EachNodeType(Case)
+#undef Case
+    if (!ret)
+        ret = &CreateUSDNode<USDNode>;
+    m_node_factories[type_name] = ret;
+    return ret;
+}
+
+void USDScene::ReadGraph::run()
+{
+    for (auto task : roots)
+        task->try_put(tbb::flow::continue_msg());
+    graph->wait_for_all();
+}
+
+void USDScene::ReadGraph::clear()
+{
+    roots.clear();
+    tasks.clear();
+    graph.reset();
+}
+
+void USDScene::buildReadGraphs()
+{
+    clearReadGraphs();
 
-        if (!c) {
-            c = new USDNode(n, cprim, true);
+    // a node is animated if it has time-varying attributes or depends on animated nodes
+    std::map<USDNode*, bool> visited;
+    std::function<bool(USDNode*)> resolve = [&](USDNode* n) -> bool {
+        if (visited.find(n) != visited.end())
+            return n->m_animated;
+        visited[n] = true;
+
+        std::vector<USDNode*> deps;
+        n->getReadDependencies(deps);
+        bool animated = n->isTimeVarying();
+        for (auto d : deps) {
+            if (resolve(d))
+                animated = true;
         }
+        n->m_animated = animated;
+        return animated;
+    };
 
-        constructTree(c);
+    std::vector<USDNode*> all, animated;
+    for (auto& n : m_nodes) {
+        all.push_back(n.get());
+        if (resolve(n.get()))
+            animated.push_back(n.get());
     }
+    buildReadGraph(m_read_graph_all, all);
+    buildReadGraph(m_read_graph_animated, animated);
+}
+
+void USDScene::buildReadGraph(ReadGraph& dst, const std::vector<USDNode*>& nodes)
+{
+    dst.clear();
+    dst.graph.reset(new tbb::flow::graph());
+
+    std::map<USDNode*, ReadTask*> tasks;
+    for (auto node : nodes) {
+        auto task = new ReadTask(*dst.graph, [this, node](const tbb::flow::continue_msg&) {
+            g_current_scene = this;
+            node->read(m_read_time);
+        });
+        dst.tasks.emplace_back(task);
+        tasks[node] = task;
+    }
+
+    // a task starts when all tasks of its dependencies are done. tasks without dependencies are roots.
+    // dependencies not in nodes are not read in this graph (e.g. static parents of animated nodes).
+    std::vector<USDNode*> deps;
+    for (auto node : nodes) {
+        auto task = tasks[node];
+        deps.clear();
+        node->getReadDependencies(deps);
+        std::sort(deps.begin(), deps.end());
+        deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+
+        int num_edges = 0;
+        for (auto d : deps) {
+            auto it = tasks.find(d);
+            if (it != tasks.end() && it->second != task) {
+                tbb::flow::make_edge(*it->second, *task);
+                ++num_edges;
+            }
+        }
+        if (num_edges == 0)
+            dst.roots.push_back(task);
+    }
+}
+
+void USDScene::clearReadGraphs()
+{
+    m_read_graph_all.clear();
+    m_read_graph_animated.clear();
+    m_read_all_nodes = true;
 }
 
 void USDScene::close()
 {
+    clearReadGraphs();
+    m_clip_layer = {};
+    m_manifest_layer = {};
+    m_clip_paths.clear();
+    m_clip_start_times.clear();
+    m_layer = {};
     m_stage = {};
 }
 
@@ -1234,11 +2082,74 @@ void USDScene::read()
     double time = m_scene->time_current;
     UsdTimeCode t = toTimeCode(time);
 
-    for (auto& n : m_nodes)
-        n->read(t);
+    // graphs are built on first read because dependencies are resolved in beforeRead()
+    m_read_time = t;
+    if (!m_read_graph_all.graph)
+        buildReadGraphs();
+
+    if (m_read_all_nodes) {
+        m_read_all_nodes = false;
+        m_read_graph_all.run();
+        for (auto& n : m_nodes)
+            n->m_node->updated = true;
+        m_static_nodes_updated = true;
+    }
+    else {
+        // static nodes keep the data of the last read. their flags need to be cleared only once.
+        if (m_static_nodes_updated) {
+            m_static_nodes_updated = false;
+            for (auto& n : m_nodes)
+                n->m_node->updated = n->m_animated;
+        }
+        m_read_graph_animated.run();
+    }
     ++m_read_count;
 }
 
+void USDScene::invalidate()
+{
+    m_read_all_nodes = true;
+}
+
+bool USDScene::load(const char* path_)
+{
+    if (!m_stage || !m_root)
+        return false;
+
+    // paths outside of the population mask can't be loaded. changing the mask recomposes the whole stage.
+    SdfPath path(path_);
+    if (!m_stage->GetPopulationMask().Includes(path))
+        return false;
+
+    g_current_scene = this;
+    m_stage->Load(path);
+    bool prototypes_removed = removeExpiredPrototypes();
+
+    // construct new nodes under the nearest existing ancestor
+    USDNode* parent = nullptr;
+    for (auto p = path; !parent && !p.IsEmpty(); p = p.GetParentPath())
+        parent = p.IsAbsoluteRootPath() ? m_root : findUSDNodeImpl(p.GetString());
+    if (!parent)
+        return false;
+
+    size_t num_nodes = m_nodes.size();
+    constructChildren(parent);
+    constructPrototypes();
+    for (size_t i = num_nodes; i < m_nodes.size(); ++i)
+        m_nodes[i]->beforeRead();
+
+    // existing instances may refer to reassigned prototypes
+    for (size_t i = 0; i < num_nodes; ++i) {
+        if (auto inst = dynamic_cast<USDInstanceNode*>(m_nodes[i].get()))
+            inst->resolvePrototype();
+    }
+
+    // new nodes have not been read yet
+    if (m_nodes.size() != num_nodes || prototypes_removed)
+        invalidate();
+    return true;
+}
+
 void USDScene::write()
 {
     g_current_scene = this;
@@ -1246,11 +2157,24 @@ void USDScene::write()
     UsdTimeCode t = toTimeCode(time);
     if (m_write_count == 0)
         m_prev_time = t;
+    int clip_frames = m_scene->write_options.clip_frames;
+    if (clip_frames > 0 && m_write_count % clip_frames == 0)
+        beginClip(t);
 
     for (auto& n : m_nodes) {
         if (n->m_write_count++ == 0)
             n->beforeWrite();
-        n->write(t);
+        n->prepareWrite(t);
+    }
+    // converting node data into samples is independent per node. only authoring to the stage needs to be serial.
+    tbb::parallel_for(size_t(0), m_nodes.size(), [this, t](size_t i) {
+        m_nodes[i]->prepareSample(t);
+    });
+    {
+        // defer change processing and notifications until all nodes are written
+        SdfChangeBlock block;
+        for (auto& n : m_nodes)
+            n->write(t);
     }
     ++m_write_count;
     m_prev_time = t;
@@ -1352,6 +2276,7 @@ bool USDScene::wrapNode(Node* node)
 
     if (ret) {
         m_nodes.push_back(USDNodePtr(ret));
+        clearReadGraphs();
     }
     return ret;
 }
@@ -1371,6 +2296,34 @@ UsdStageRefPtr& USDScene::getStage()
     return m_stage;
 }
 
+const SdfLayerHandle& USDScene::getLayer() const
+{
+    return m_layer;
+}
+
+SdfLayerHandle USDScene::getSampleLayer(const UsdAttribute& attr)
+{
+    auto path = attr.GetPath();
+    if (m_clip_layer) {
+        // specs are created on demand. the manifest declares every attribute that has samples in clips.
+        if (!m_clip_layer->HasSpec(path)) {
+            auto type = attr.GetTypeName();
+            SdfJustCreatePrimAttributeInLayer(m_clip_layer, path, type);
+            if (!m_manifest_layer->HasSpec(path))
+                SdfJustCreatePrimAttributeInLayer(m_manifest_layer, path, type);
+        }
+        return m_clip_layer;
+    }
+    if (m_layer && m_layer->HasSpec(path))
+        return m_layer;
+    return {};
+}
+
+int USDScene::getClipIndex() const
+{
+    return (int)m_clip_paths.size();
+}
+
 UsdTimeCode USDScene::toTimeCode(double time) const
 {
     return UsdTimeCode(time * m_frame_rate);
@@ -10,6 +10,68 @@ namespace sg {
 
 class USDNode;
 class USDScene;
+class USDSkelAnimationNode;
+
+// attribute reader that classifies the attribute once.
+// fetch() reads a time-invariant attribute only the first time and returns false after that
+// (the sample given on the first time should be kept by caller).
+class USDAttrQuery
+{
+public:
+    USDAttrQuery() {}
+    USDAttrQuery(const UsdAttribute& attr)
+    {
+        if (attr) {
+            m_query = UsdAttributeQuery(attr);
+            m_time_varying = m_query.ValueMightBeTimeVarying();
+        }
+    }
+    explicit operator bool() const { return m_query.IsValid(); }
+    bool isTimeVarying() const { return m_time_varying; }
+
+    template<class T>
+    bool fetch(T& dst, UsdTimeCode t)
+    {
+        if (!m_query.IsValid() || (m_fetched && !m_time_varying))
+            return false;
+        m_fetched = true;
+        return m_query.Get(&dst, t);
+    }
+
+private:
+    UsdAttributeQuery m_query;
+    bool m_time_varying = false;
+    bool m_fetched = false;
+};
+
+// same as USDAttrQuery for primvars. values and indices are considered.
+class USDPrimvarQuery
+{
+public:
+    USDPrimvarQuery() {}
+    USDPrimvarQuery(const UsdGeomPrimvar& pv)
+        : m_primvar(pv)
+    {
+        if (m_primvar)
+            m_time_varying = m_primvar.ValueMightBeTimeVarying();
+    }
+    explicit operator bool() const { return (bool)m_primvar; }
+    bool isTimeVarying() const { return m_time_varying; }
+
+    template<class T>
+    bool fetchFlattened(T& dst, UsdTimeCode t)
+    {
+        if (!m_primvar || (m_fetched && !m_time_varying))
+            return false;
+        m_fetched = true;
+        return m_primvar.ComputeFlattened(&dst, t);
+    }
+
+private:
+    UsdGeomPrimvar m_primvar;
+    bool m_time_varying = false;
+    bool m_fetched = false;
+};
 
 class USDNode
 {
@@ -22,8 +84,18 @@ public:
 
     virtual void beforeRead();
     virtual void read(UsdTimeCode t);
+    // nodes that must be read before this node in the same frame
+    virtual void getReadDependencies(std::vector<USDNode*>& dst);
+    // true if any of attributes read by read() may change over time. valid after beforeRead().
+    virtual bool isTimeVarying() const;
 
     virtual void beforeWrite();
+    // called every frame before write(). create prims and properties write() needs here,
+    // because write() is called in SdfChangeBlock and new prims are not available until it ends.
+    virtual void prepareWrite(UsdTimeCode t);
+    // called every frame after prepareWrite() of all nodes, in parallel with other nodes.
+    // convert node data into sample holders here. must not modify the stage.
+    virtual void prepareSample(UsdTimeCode t);
     virtual void write(UsdTimeCode t);
 
     void setNode(Node *node);
@@ -48,6 +120,22 @@ public:
 
     template<class T>
     void padSample(const UsdAttribute& attr, UsdTimeCode t, const T& default_sample = {});
+    template<class T>
+    void setSample(const UsdAttribute& attr, const T& v, UsdTimeCode t);
+
+    // last sample written by setSampleIfChanged()
+    template<class T>
+    struct HeldSample
+    {
+        T value{};
+        UsdTimeCode time;
+        bool valid = false;
+        bool held = false; // same value has been passed after it was written
+        int clip = 0; // value clip that time was written to
+    };
+    // same as setSample() but skips v if it is identical to the previous sample.
+    template<class T>
+    void setSampleIfChanged(const UsdAttribute& attr, const T& v, HeldSample<T>& prev, UsdTimeCode t);
 
 public:
     UsdPrim m_prim;
@@ -56,8 +144,10 @@ public:
     USDNode* m_parent = nullptr;
     std::vector<USDNode*> m_children;
     uint32_t m_write_count = 0;
+    bool m_animated = false; // time-varying or depends on time-varying nodes. read() is called every frame.
 
     UsdAttribute m_attr_display_name;
+    std::string m_display_name; // last written
 };
 using USDNodePtr = std::shared_ptr<USDNode>;
 
@@ -79,12 +169,29 @@ public:
 
     USDXformNode(USDNode* parent, UsdPrim prim, bool create_node = true);
     USDXformNode(Node* n, UsdPrim prim);
+    void beforeRead() override;
     void read(UsdTimeCode t) override;
+    bool isTimeVarying() const override;
+    void beforeWrite() override;
+    void prepareWrite(UsdTimeCode t) override;
     void write(UsdTimeCode t) override;
 
 private:
     UsdGeomXformable m_xform;
     std::vector<UsdGeomXformOp> m_xf_ops;
+
+    // read
+    UsdGeomXformable::XformQuery m_xf_query;
+    USDAttrQuery m_query_visibility;
+    bool m_xf_fetched = false;
+
+    // sample holder
+    TfToken m_visibility;
+    GfMatrix4d m_local_matrix;
+
+    // write
+    HeldSample<TfToken> m_held_visibility;
+    HeldSample<GfMatrix4d> m_held_matrix;
 };
 
 
@@ -140,12 +247,59 @@ public:
     USDSkeletonNode(Node* n, UsdPrim prim);
     void beforeRead() override;
     void read(UsdTimeCode t) override;
+    bool isTimeVarying() const override;
     void beforeWrite() override;
+    void prepareSample(UsdTimeCode t) override;
     void write(UsdTimeCode t) override;
 
+    // animation bound to this skeleton by skel:animationSource. meshes bound to this skeleton get blendshape weights from it.
+    USDSkelAnimationNode* findAnimationSource();
+    // blendshape weights of meshes bound to this skeleton are written to its animation.
+    // returns channel names for the mesh's skel:blendShapes. names are made unique among the meshes.
+    // channels are fixed once weights are written. blendshapes of meshes added after that are not animated.
+    VtArray<TfToken> addBlendshapeChannels(const MeshNode* mesh, const VtArray<TfToken>& names);
+
 private:
+    UsdSkelAnimation& getAnimation();
+
     UsdSkelSkeleton m_skel;
     UsdSkelCache m_cache;
+
+    // read
+    UsdSkelSkeletonQuery m_skel_query;
+    USDAttrQuery m_query_bind_transforms;
+    USDAttrQuery m_query_rest_transforms;
+    bool m_joints_time_varying = false;
+    bool m_joints_fetched = false;
+
+    // sample holder
+    VtArray<GfMatrix4d> m_bind_transforms;
+    VtArray<GfMatrix4d> m_rest_transforms;
+    VtArray<GfMatrix4d> m_joint_transforms;
+
+    // write. joint animation is written as per-joint TRS to a SkelAnimation bound to this skeleton.
+    UsdSkelAnimation m_animation;
+    VtArray<GfVec3f> m_translations;
+    VtArray<GfQuatf> m_rotations;
+    VtArray<GfVec3h> m_scales;
+    RawVector<float4x4> m_local_matrices; // gathered from joints for mu::ExtractTRS()
+    RawVector<quatf> m_local_rotations;
+    RawVector<float3> m_local_scales;
+    HeldSample<VtArray<GfVec3f>> m_held_translations;
+    HeldSample<VtArray<GfQuatf>> m_held_rotations;
+    HeldSample<VtArray<GfVec3h>> m_held_scales;
+
+    struct BlendshapeChannels
+    {
+        const MeshNode* mesh;
+        size_t offset;
+        size_t count;
+    };
+    std::vector<BlendshapeChannels> m_bs_meshes;
+    VtArray<TfToken> m_bs_channels;
+    VtArray<float> m_bs_weights;
+    HeldSample<VtArray<float>> m_held_bs_weights;
+    bool m_bs_channels_fixed = false;
 };
 
 
@@ -158,6 +312,8 @@ public:
     USDSkelAnimationNode(USDNode* parent, UsdPrim prim);
     USDSkelAnimationNode(Node* n, UsdPrim prim);
     void beforeRead() override;
+    void read(UsdTimeCode t) override;
+    bool isTimeVarying() const override;
 
 
     struct BlendshapeData
@@ -166,8 +322,9 @@ public:
         float weight;
     };
 
-    // will be called from USDMeshNode. USDMeshNode's read() possibly be called before USDSkelAnimationNode's.
-    // so this method will do read data from USD on-demand.
+    // will be called from USDMeshNode. read() fetches weights and meshes depend on this node,
+    // so USDScene::read() doesn't call this concurrently with the fetch.
+    // (still reads data from USD on-demand if called outside of USDScene::read())
     std::vector<const BlendshapeData*>& getBlendshapeData(UsdTimeCode t);
 
 private:
@@ -189,7 +346,11 @@ public:
     USDMeshNode(Node* n, UsdPrim prim);
     void beforeRead() override;
     void read(UsdTimeCode t) override;
+    void getReadDependencies(std::vector<USDNode*>& dst) override;
+    bool isTimeVarying() const override;
     void beforeWrite() override;
+    void prepareWrite(UsdTimeCode t) override;
+    void prepareSample(UsdTimeCode t) override;
     void write(UsdTimeCode t) override;
 
 public:
@@ -208,6 +369,18 @@ public:
     USDSkelAnimationNode* m_animation = nullptr;
     USDSkeletonNode* m_skeleton = nullptr;
 
+    // read. time-invariant attributes are fetched only once and kept in sample holders.
+    USDAttrQuery m_query_counts;
+    USDAttrQuery m_query_indices;
+    USDAttrQuery m_query_points;
+    USDAttrQuery m_query_normals;
+    USDPrimvarQuery m_query_st;
+    USDPrimvarQuery m_query_colors;
+    USDAttrQuery m_query_joint_indices;
+    USDAttrQuery m_query_joint_weights;
+    USDAttrQuery m_query_bind_transform;
+    int m_joints_per_vertex = 0;
+
     // sample holder
     VtArray<int> m_counts;
     VtArray<int> m_indices;
@@ -216,15 +389,34 @@ public:
     VtArray<GfVec2f> m_uvs;
     VtArray<GfVec4f> m_colors;
     VtArray<int> m_uv_indices;
+    VtArray<int> m_color_indices;
     VtArray<int> m_material_ids;
     VtArray<int> m_joint_indices;
     VtArray<float> m_joint_weights;
+    GfMatrix4d m_bind_transform{ 1.0 };
+
+    // write
+    HeldSample<VtArray<int>> m_held_counts;
+    HeldSample<VtArray<int>> m_held_indices;
+    HeldSample<VtArray<GfVec3f>> m_held_points;
+    HeldSample<VtArray<GfVec3f>> m_held_normals;
+    HeldSample<VtArray<GfVec2f>> m_held_uvs;
+    HeldSample<VtArray<GfVec4f>> m_held_colors;
+    HeldSample<VtArray<int>> m_held_uv_indices;
+    HeldSample<VtArray<int>> m_held_color_indices;
+    TfToken m_normals_interpolation;
+    TfToken m_normals_interpolation_sample; // interpolation of m_normals. set by prepareSample()
+    UsdSkelAnimation m_bs_animation; // blendshape weights of meshes that are not bound to a skeleton
+    VtArray<float> m_bs_weights;
+    HeldSample<VtArray<float>> m_held_bs_weights;
 
     // subset data
     struct SubsetData
     {
         UsdGeomSubset subset;
+        USDAttrQuery query;
         VtArray<int> sample;
+        HeldSample<VtArray<int>> held;
         FaceSetPtr dst;
     };
     std::vector<SubsetData> m_isubsets;
@@ -242,17 +434,54 @@ public:
     USDInstancerNode(Node* n, UsdPrim prim);
     void beforeRead() override;
     void read(UsdTimeCode t) override;
+    bool isTimeVarying() const override;
     void beforeWrite() override;
+    void prepareSample(UsdTimeCode t) override;
     void write(UsdTimeCode t) override;
 
+    bool composeMatrices(UsdTimeCode t);
+
 public:
     UsdGeomPointInstancer m_instancer;
     VtArray<int> m_proto_indices;
     VtArray<GfMatrix4d> m_matrices;
 
+    // read
+    USDAttrQuery m_query_proto_indices;
+    bool m_matrices_time_varying = false;
+    bool m_matrices_fetched = false;
+    bool m_compose_matrices = false; // instance transforms can be composed from TRS without ComputeInstanceTransformsAtTime()
+    bool m_matrices_composed = false;
+    RawVector<float4x4> m_composed_matrices;
+
     VtArray<GfVec3f> m_positions;
     VtArray<GfQuath> m_orientations;
     VtArray<GfVec3f> m_scales;
+    RawVector<quatf> m_rotations; // m_orientations in float for mu::ExtractTRS() / mu::ComposeTRS()
+    RawVector<float3> m_scales_tmp; // used when scales are not authored
+
+    // write
+    HeldSample<VtArray<int>> m_held_proto_indices;
+    HeldSample<VtArray<GfVec3f>> m_held_positions;
+    HeldSample<VtArray<GfQuath>> m_held_orientations;
+    HeldSample<VtArray<GfVec3f>> m_held_scales;
+};
+
+
+// instance prim (UsdPrim::IsInstance()). read-only.
+// the prototype is wrapped once and shared by all instances. each instance is an InstancerNode
+// that has the prototype as its only proto, so instances keep their own transforms.
+class USDInstanceNode : public USDXformNode
+{
+using super = USDXformNode;
+public:
+    USDInstanceNode(USDNode* parent, UsdPrim prim);
+    void beforeRead() override;
+    void read(UsdTimeCode t) override;
+    void resolvePrototype();
+
+private:
+    USDNode* m_prototype = nullptr;
 };
 
 
@@ -266,6 +495,7 @@ public:
     USDMaterialNode(Node* n, UsdPrim prim);
     void beforeRead() override;
     void read(UsdTimeCode t) override;
+    bool isTimeVarying() const override;
     void beforeWrite() override;
 
 public:
@@ -317,6 +547,8 @@ public:
     bool save() override;
     void close() override;
     void read() override;
+    void invalidate() override;
+    bool load(const char* path) override;
     void write() override;
 
     bool isNodeTypeSupported(Node::Type type) override;
@@ -326,6 +558,9 @@ public:
 
     Scene* getHostScene();
     UsdStageRefPtr& getStage();
+    const SdfLayerHandle& getLayer() const;
+    SdfLayerHandle getSampleLayer(const UsdAttribute& attr);
+    int getClipIndex() const;
     UsdTimeCode toTimeCode(double time) const;
     UsdTimeCode getPrevTime() const;
     USDNode* findUSDNodeImpl(const std::string& path);
@@ -344,15 +579,54 @@ public:
     }
 
 private:
+    using NodeFactory = USDNode* (*)(USDNode* parent, UsdPrim prim);
+    NodeFactory findNodeFactory(const UsdPrim& prim);
     void registerNode(USDNode* n);
     void constructTree(USDNode* n);
+    void constructChildren(USDNode* n);
+    void constructPrototypes();
+    bool removeExpiredPrototypes();
+    using ReadTask = tbb::flow::continue_node<tbb::flow::continue_msg>;
+    struct ReadGraph
+    {
+        std::unique_ptr<tbb::flow::graph> graph;
+        std::vector<std::unique_ptr<ReadTask>> tasks; // must be destroyed before graph
+        std::vector<ReadTask*> roots;
+
+        void run();
+        void clear();
+    };
+    void buildReadGraphs();
+    void buildReadGraph(ReadGraph& dst, const std::vector<USDNode*>& nodes);
+    void clearReadGraphs();
     template<class NodeT> USDNode* createNodeImpl(USDNode* parent, std::string path);
     template<class NodeT> USDNode* wrapNodeImpl(Node* node);
+    void beginClip(UsdTimeCode t);
+    void endClip();
+    void updateClips(size_t num_clips);
 
     UsdStageRefPtr m_stage;
+    SdfLayerHandle m_layer; // edit target. samples are written directly to this.
+
+    // value clips (WriteOptions::clip_frames). the root layer has only scene description and clip metadata,
+    // time samples go to the current clip layer so that each save doesn't grow with the length of the recording.
+    SdfLayerRefPtr m_clip_layer;
+    SdfLayerRefPtr m_manifest_layer;
+    std::vector<std::string> m_clip_paths; // relative to the root layer
+    std::vector<double> m_clip_start_times;
     std::vector<USDNodePtr> m_nodes;
-    std::map<std::string, USDNode*> m_node_table;
+    std::unordered_map<std::string, USDNode*> m_node_table;
     USDRootNode* m_root = nullptr;
+    // prim type name -> factory. known types are prebuilt and others are resolved by schema on first appearance.
+    std::unordered_map<TfToken, NodeFactory, TfToken::HashFunctor> m_node_factories;
+
+    // read() runs nodes as a task graph. edges are dependencies given by USDNode::getReadDependencies().
+    // after the first read, only animated nodes (USDNode::m_animated) are read.
+    ReadGraph m_read_graph_all;
+    ReadGraph m_read_graph_animated;
+    UsdTimeCode m_read_time;
+    bool m_read_all_nodes = true;
+    bool m_static_nodes_updated = false;
 
     Scene* m_scene = nullptr;
     UsdTimeCode m_prev_time;
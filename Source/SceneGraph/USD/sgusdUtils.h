@@ -149,4 +149,42 @@ template<class T> inline void SetValue(const T& dst, const WrapMode& v, UsdTimeC
 }
 
 
+#if PXR_VERSION >= 2005
+// owner of a buffer handed over by SharedVector::release().
+// freed when the last VtArray that refers it is gone.
+template<class V>
+struct USDForeignBuffer : public Vt_ArrayForeignDataSource
+{
+    void* data;
+
+    USDForeignBuffer(void* d) : Vt_ArrayForeignDataSource(&detached), data(d) {}
+
+    static void detached(Vt_ArrayForeignDataSource* self)
+    {
+        auto* buf = static_cast<USDForeignBuffer*>(self);
+        V::deallocate(buf->data, 0);
+        delete buf;
+    }
+};
+#endif
+
+// hand over src's buffer to dst without copy if release is true and src owns it. otherwise copy.
+// src becomes empty in the former case.
+template<class VT, class T, int A>
+inline void MoveToVtArray(VtArray<VT>& dst, SharedVector<T, A>& src, bool release = true)
+{
+    static_assert(sizeof(VT) == sizeof(T), "element size mismatch");
+    size_t n = src.size();
+#if PXR_VERSION >= 2005
+    if (n > 0 && release) {
+        if (auto* data = src.release()) {
+            dst = VtArray<VT>(new USDForeignBuffer<SharedVector<T, A>>(data), (VT*)data, n);
+            return;
+        }
+    }
+#endif
+    dst.assign((const VT*)src.cdata(), (const VT*)src.cdata() + n);
+}
+
+
 } // namespace sg
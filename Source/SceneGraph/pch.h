@@ -21,5 +21,7 @@
 #include <sstream>
 #include <fstream>
 #include <future>
+#include <mutex>
+#include <condition_variable>
 #include <random>
 #include <numeric>
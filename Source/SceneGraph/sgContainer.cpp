@@ -0,0 +1,327 @@
+#include "pch.h"
+#include "sgContainer.h"
+#include "sgSerializationImpl.h"
+
+namespace sg {
+
+static const char sgcMagic[8] = "sgc" sgVersionString;
+
+#define EachSceneMember(F)\
+    F(scene.path) F(scene.root_node) F(scene.up_axis)\
+    F(scene.frame_count) F(scene.frame_rate) F(scene.time_start) F(scene.time_end) F(scene.time_current)
+
+bool SceneContainer::write(std::ostream& os, const Scene& scene)
+{
+    auto& nodes = scene.nodes;
+    uint32_t num_nodes = (uint32_t)nodes.size();
+
+    // node table
+    RawVector<char> table_buf;
+    mu::MemoryStream table_stream(table_buf);
+    serializer table(table_stream);
+    {
+        auto& s = table;
+
+        // register scene and nodes first. references to them are written as handles from now on.
+        s.getHandle(&scene);
+        for (auto& n : nodes)
+            s.getHandle(n.get());
+
+        for (auto& n : nodes) {
+            std::string type_name = typeid(*n).name();
+            sgWrite(type_name);
+        }
+        EachSceneMember(sgWrite);
+        for (auto& n : nodes)
+            n->Node::serialize(s);
+
+        // joints are referenced by both skeletons and meshes. keep them in the table to make payloads independent.
+        for (auto& n : nodes) {
+            if (auto skel = dynamic_cast<SkeletonNode*>(n.get()))
+                sgWrite(skel->joints);
+        }
+    }
+    table_stream.flush();
+
+    // payloads. each node is serialized into its own buffer in parallel.
+    // references to nodes and joints are resolved by the table and other handles are local to each payload,
+    // so the result doesn't depend on the order of execution.
+    std::vector<RawVector<char>> payloads(num_nodes);
+    mu::parallel_for(0, (int)num_nodes, [&](int i) {
+        mu::MemoryStream ps(payloads[i]);
+        serializer s(ps, table);
+        nodes[i]->serialize(s);
+        ps.flush();
+    });
+
+    RawVector<uint64_t> offsets;
+    offsets.resize(num_nodes + 1);
+    offsets[0] = 0;
+    for (uint32_t i = 0; i < num_nodes; ++i)
+        offsets[i + 1] = offsets[i] + payloads[i].size();
+
+    serializer s(os);
+    sg::write_array(s, sgcMagic, 8);
+    sgWrite(num_nodes);
+    sgWrite((uint64_t)table_buf.size());
+    s.write(table_buf.cdata(), table_buf.size());
+    sgWrite(offsets);
+    for (auto& p : payloads)
+        s.write(p.cdata(), p.size());
+    return os.good();
+}
+
+
+SceneContainer::SceneContainer()
+{
+}
+
+SceneContainer::~SceneContainer()
+{
+    close();
+}
+
+bool SceneContainer::open(Scene& scene, const char* path, bool load)
+{
+    close();
+
+    auto file = std::make_shared<mu::MemoryMappedFile>();
+    if (!file->open(path))
+        return false;
+
+    mu::MappedStream is(file);
+    return open(scene, is, load);
+}
+
+bool SceneContainer::open(Scene& scene, std::istream& is, bool load)
+{
+    close();
+
+    // mapped stream can be accessed randomly. other streams are received section by section.
+    if (typeid(is) == typeid(mu::MappedStream))
+        m_file = static_cast<mu::MappedStream&>(is).getFile();
+    else
+        m_chunks = std::make_shared<std::vector<RawVector<char>>>();
+
+    deserializer d(is);
+
+    // header
+    char magic[8];
+    sg::read_array(d, magic, 8);
+    if (!is || std::strncmp(magic, sgcMagic, 8) != 0) {
+        close();
+        return false;
+    }
+    uint32_t num_nodes;
+    uint64_t table_size;
+    sgRead(num_nodes);
+    sgRead(table_size);
+
+    // node table
+    if (m_file) {
+        m_table_pos = (uint64_t)is.tellg();
+        is.seekg((std::streamoff)table_size, std::ios::cur);
+    }
+    else {
+        m_chunks->resize(num_nodes + 1);
+        if (!receive((*m_chunks)[0], is, table_size)) {
+            close();
+            return false;
+        }
+    }
+
+    // offsets
+    sgRead(m_offsets);
+    if (!is || m_offsets.size() != num_nodes + 1 || !readTable(scene, num_nodes)) {
+        close();
+        return false;
+    }
+
+    if (m_file) {
+        m_payload_pos = (uint64_t)is.tellg();
+        if (load)
+            loadNodes();
+        return true;
+    }
+    else {
+        return receivePayloads(is, load);
+    }
+}
+
+bool SceneContainer::receive(RawVector<char>& dst, std::istream& is, uint64_t size)
+{
+    // allocate at final size. SharedVector will directly reference this.
+    dst.resize_discard((size_t)size);
+    is.read(dst.data(), (std::streamsize)size);
+    return (uint64_t)is.gcount() == size;
+}
+
+bool SceneContainer::receivePayloads(std::istream& is, bool load)
+{
+    int num_nodes = (int)m_nodes.size();
+    auto& chunks = *m_chunks;
+
+    // decode on a worker thread while receiving subsequent payloads
+    std::mutex mutex;
+    std::condition_variable cond;
+    int num_received = 0;
+    bool failed = false;
+
+    std::future<void> task;
+    if (load) {
+        task = std::async(std::launch::async, [&]() {
+            for (int i = 0; i < num_nodes; ++i) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond.wait(lock, [&]() { return num_received > i || failed; });
+                    if (num_received <= i)
+                        break;
+                }
+                loadNodeImpl(i);
+            }
+        });
+    }
+
+    for (int i = 0; i < num_nodes; ++i) {
+        bool ok = receive(chunks[i + 1], is, m_offsets[i + 1] - m_offsets[i]);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (ok)
+                ++num_received;
+            else
+                failed = true;
+        }
+        cond.notify_one();
+        if (!ok)
+            break;
+    }
+    if (task.valid())
+        task.wait();
+
+    if (failed) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<std::istream> SceneContainer::openSection(int i)
+{
+    // i == -1: node table
+    std::unique_ptr<std::istream> ret;
+    if (m_file) {
+        ret.reset(new mu::MappedStream(m_file));
+        uint64_t pos = i < 0 ? m_table_pos : m_payload_pos + m_offsets[i];
+        ret->seekg((std::streamoff)pos, std::ios::beg);
+    }
+    else {
+        ret.reset(new mu::MemoryStream((*m_chunks)[i + 1]));
+    }
+    return ret;
+}
+
+bool SceneContainer::readTable(Scene& scene, uint32_t num_nodes)
+{
+    m_table_stream = openSection(-1);
+    m_table.reset(new deserializer(*m_table_stream));
+    auto& d = *m_table;
+
+    // scene and nodes are registered in the same order as write()
+    uint32_t handle = 1;
+    d.setPointer({ handle++ }, &scene);
+
+    std::vector<NodePtr> nodes(num_nodes);
+    for (auto& n : nodes) {
+        std::string type_name;
+        sgRead(type_name);
+        n.reset(create_instance<Node>(type_name.c_str()));
+        if (!n)
+            return false;
+        d.setPointer({ handle++ }, n.get());
+    }
+    EachSceneMember(sgRead);
+    for (auto& n : nodes)
+        n->Node::deserialize(d);
+    for (auto& n : nodes) {
+        if (auto skel = dynamic_cast<SkeletonNode*>(n.get()))
+            sgRead(skel->joints);
+    }
+    if (!*m_table_stream)
+        return false;
+
+    m_scene = &scene;
+    m_nodes.resize(num_nodes);
+    for (uint32_t i = 0; i < num_nodes; ++i)
+        m_nodes[i] = nodes[i].get();
+    m_loaded.assign(num_nodes, 0);
+
+    scene.nodes = std::move(nodes);
+    if (m_file)
+        scene.data_holder = m_file;
+    else
+        scene.data_holder = m_chunks;
+    if (scene.impl) {
+        for (auto* n : m_nodes)
+            scene.impl->wrapNode(n);
+    }
+    return true;
+}
+#undef EachSceneMember
+
+void SceneContainer::close()
+{
+    m_scene = nullptr;
+    m_file.reset();
+    m_chunks.reset();
+    m_table.reset();
+    m_table_stream.reset();
+    m_offsets.clear();
+    m_table_pos = 0;
+    m_payload_pos = 0;
+    m_nodes.clear();
+    m_loaded.clear();
+}
+
+int SceneContainer::getIndex(const Node* n) const
+{
+    if (!n)
+        return -1;
+    if (n->id < m_nodes.size() && m_nodes[n->id] == n)
+        return (int)n->id;
+    auto it = std::find(m_nodes.begin(), m_nodes.end(), n);
+    return it == m_nodes.end() ? -1 : (int)std::distance(m_nodes.begin(), it);
+}
+
+bool SceneContainer::isLoaded(const Node* n) const
+{
+    int i = getIndex(n);
+    return i != -1 && m_loaded[i];
+}
+
+void SceneContainer::loadNodeImpl(int i)
+{
+    auto is = openSection(i);
+    deserializer d(*is, *m_table);
+    m_nodes[i]->deserialize(d);
+    m_loaded[i] = 1;
+}
+
+bool SceneContainer::loadNode(Node* n)
+{
+    int i = getIndex(n);
+    if (i == -1)
+        return false;
+    if (!m_loaded[i])
+        loadNodeImpl(i);
+    return true;
+}
+
+void SceneContainer::loadNodes()
+{
+    mu::parallel_for(0, (int)m_nodes.size(), [this](int i) {
+        if (!m_loaded[i])
+            loadNodeImpl(i);
+    });
+}
+
+} // namespace sg
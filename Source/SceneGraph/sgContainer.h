@@ -0,0 +1,58 @@
+#pragma once
+#include "SceneGraph.h"
+
+namespace sg {
+
+// seekable sectioned scene container.
+//   header     : magic, number of nodes, size of node table
+//   node table : types of nodes, members of Scene, hierarchy (members of Node) and joints
+//   offsets    : offset of each node's payload
+//   payloads   : Node::serialize() of each node
+// references to nodes and joints are resolved via the node table,
+// so each payload can be decoded independently (on demand or in parallel).
+class SceneContainer
+{
+public:
+    // payloads are serialized in parallel
+    static bool write(std::ostream& os, const Scene& scene);
+
+    SceneContainer();
+    ~SceneContainer();
+
+    // read header and node table. node hierarchy is constructed and payloads are loaded on demand.
+    // if load is true, all payloads are loaded before return.
+    // scene keeps the data alive as long as nodes refer it.
+    bool open(Scene& scene, const char* path, bool load = false); // map file
+    // if is is not mu::MappedStream, sections are received one by one at their final size
+    // (no intermediate buffer for the whole stream). if load is true, payloads are decoded
+    // on a worker thread while subsequent ones are being received.
+    bool open(Scene& scene, std::istream& is, bool load = false);
+    void close();
+
+    bool isLoaded(const Node* n) const;
+    bool loadNode(Node* n);
+    void loadNodes(); // load all payloads not loaded yet, in parallel
+
+private:
+    bool readTable(Scene& scene, uint32_t num_nodes);
+    bool receive(RawVector<char>& dst, std::istream& is, uint64_t size);
+    bool receivePayloads(std::istream& is, bool load);
+    std::unique_ptr<std::istream> openSection(int i); // -1: node table
+    int getIndex(const Node* n) const;
+    void loadNodeImpl(int index);
+
+    Scene* m_scene = nullptr;
+    // source of sections. mapped file or chunks received from stream ([0]: node table, [1...]: payloads)
+    mu::MemoryMappedFilePtr m_file;
+    std::shared_ptr<std::vector<RawVector<char>>> m_chunks;
+    std::unique_ptr<std::istream> m_table_stream;
+    std::unique_ptr<deserializer> m_table; // payloads resolve references via this
+    RawVector<uint64_t> m_offsets;
+    uint64_t m_table_pos = 0;
+    uint64_t m_payload_pos = 0;
+    std::vector<Node*> m_nodes;
+    std::vector<char> m_loaded; // not vector<bool> to be updated in parallel
+};
+sgDeclPtr(SceneContainer);
+
+} // namespace sg
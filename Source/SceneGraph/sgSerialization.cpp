@@ -103,6 +103,8 @@ struct serializer::impl
 {
     std::ostream& stream;
     std::map<pointer_t, uint32_t> pointer_records;
+    const impl* base = nullptr;
+    uint32_t base_count = 0;
 
     impl(std::ostream& s) : stream(s) {}
 };
@@ -112,6 +114,13 @@ serializer::serializer(std::ostream& s)
 {
 }
 
+serializer::serializer(std::ostream& s, const serializer& base)
+    : m_impl(std::make_unique<impl>(s))
+{
+    m_impl->base = base.m_impl.get();
+    m_impl->base_count = base.getRecordCount();
+}
+
 serializer::~serializer()
 {
 }
@@ -131,10 +140,17 @@ hptr serializer::getHandle(pointer_t v)
     if (!v)
         return { 0 };
 
+    // pointers known by base are always references
+    for (auto* b = m_impl->base; b; b = b->base) {
+        auto it = b->pointer_records.find(v);
+        if (it != b->pointer_records.end())
+            return { it->second };
+    }
+
     hptr ret;
     uint32_t& index = m_impl->pointer_records[v];
     if (index == 0) {
-        index = (uint32_t)m_impl->pointer_records.size();
+        index = m_impl->base_count + (uint32_t)m_impl->pointer_records.size();
         ret = { index | hptr::kFleshFlag };
     }
     else {
@@ -143,6 +159,11 @@ hptr serializer::getHandle(pointer_t v)
     return ret;
 }
 
+uint32_t serializer::getRecordCount() const
+{
+    return m_impl->base_count + (uint32_t)m_impl->pointer_records.size();
+}
+
 
 // deserializer
 
@@ -150,8 +171,18 @@ struct deserializer::impl
 {
     std::istream& stream;
     std::vector<Record> pointer_records;
+    uint32_t record_count = 0;
+    impl* base = nullptr;
+    uint32_t base_count = 0;
 
     impl(std::istream& s) : stream(s) {}
+
+    Record& get(uint32_t index)
+    {
+        if (base && index <= base_count)
+            return base->get(index);
+        return pointer_records[index - base_count];
+    }
 };
 
 deserializer::deserializer(std::istream& s)
@@ -159,6 +190,14 @@ deserializer::deserializer(std::istream& s)
 {
 }
 
+deserializer::deserializer(std::istream& s, deserializer& base)
+    : m_impl(std::make_unique<impl>(s))
+{
+    m_impl->base = base.m_impl.get();
+    m_impl->base_count = base.getRecordCount();
+    m_impl->record_count = m_impl->base_count;
+}
+
 deserializer::~deserializer()
 {
 }
@@ -176,15 +215,18 @@ std::istream& deserializer::getStream()
 void deserializer::setPointer(hptr h, pointer_t v)
 {
     uint32_t index = h.getIndex();
+    m_impl->record_count = std::max(m_impl->record_count, index);
+
+    uint32_t local = index - m_impl->base_count;
     auto& records = m_impl->pointer_records;
-    while (records.size() <= index)
+    while (records.size() <= local)
         records.resize(std::max<size_t>(256, records.size() * 2));
-    records[index].pointer = v;
+    records[local].pointer = v;
 }
 
 deserializer::Record& deserializer::getRecord(hptr h)
 {
-    return m_impl->pointer_records[h.getIndex()];
+    return m_impl->get(h.getIndex());
 }
 
 bool deserializer::getPointer_(hptr h, pointer_t& v)
@@ -195,17 +237,21 @@ bool deserializer::getPointer_(hptr h, pointer_t& v)
     }
 
     uint32_t index = h.getIndex();
-    auto& records = m_impl->pointer_records;
 #ifdef sgDebug
-    if (index >= records.size()) {
+    if (index > m_impl->record_count) {
         // should not be here
         mu::DbgBreak();
         v = nullptr;
         return false;
     }
 #endif
-    v = records[index].pointer;
+    v = m_impl->get(index).pointer;
     return true;
 }
 
+uint32_t deserializer::getRecordCount() const
+{
+    return m_impl->record_count;
+}
+
 } // namespace sg
@@ -27,11 +27,15 @@ public:
     using pointer_t = const void*;
 
     serializer(std::ostream& s);
+    // inherit pointer records of base. pointers known by base are written as references,
+    // and new handles are numbered after base's ones. base must not be modified while this is alive.
+    serializer(std::ostream& s, const serializer& base);
     ~serializer();
     void write(const void* v, size_t size);
 
     std::ostream& getStream();
     hptr getHandle(pointer_t v);
+    uint32_t getRecordCount() const;
 
 private:
     struct impl;
@@ -49,6 +53,9 @@ public:
     };
 
     deserializer(std::istream& s);
+    // counterpart of serializer(std::ostream& s, const serializer& base).
+    // base's records are referenced (not copied). base must outlive this.
+    deserializer(std::istream& s, deserializer& base);
     ~deserializer();
     void read(void* v, size_t size);
 
@@ -56,6 +63,7 @@ public:
     void setPointer(hptr h, pointer_t v);
     Record& getRecord(hptr h);
     bool getPointer_(hptr h, pointer_t& v);
+    uint32_t getRecordCount() const;
 
     template<class T>
     bool getPointer(hptr h, T*& v)
@@ -443,6 +443,14 @@ struct serializable<SharedVector<T>> : serialize_nonintrusive<SharedVector<T>>
             auto& ms = static_cast<mu::MemoryStream&>(stream);
             v.share((T*)ms.gskip(sizeof(T) * size), size);
         }
+        else if (typeid(stream) == typeid(mu::MappedStream)) {
+            // share mapped memory. the file is kept alive by Scene (see Scene::deserialize())
+            auto& ms = static_cast<mu::MappedStream&>(stream);
+            if (auto *p = ms.gskip(sizeof(T) * size))
+                v.share((T*)p, size);
+            else
+                v.clear();
+        }
         else {
             v.resize_discard(size);
             read_array(d, v.data(), size);
@@ -95,6 +95,42 @@ TestCase(Test_MulPoints)
 #endif
 }
 
+TestCase(Test_TRS)
+{
+    const int num_data = 1024;
+    RawVector<float3> t, s, t2, s2;
+    RawVector<quatf> r, r2;
+    RawVector<float4x4> m;
+    t.resize(num_data); r.resize(num_data); s.resize(num_data);
+    for (int i = 0; i < num_data; ++i) {
+        t[i] = { (float)i * 0.1f, (float)i * -0.2f, 1.0f };
+        r[i] = rotate_zxy(float3{ (float)i * 7.0f, (float)i * 3.0f, (float)i * 11.0f });
+        s[i] = i % 3 == 0 ? float3::one() : float3{ 1.0f + (float)(i % 5), 2.0f, 0.5f };
+    }
+
+    m.resize(num_data);
+    ComposeTRS(t.cdata(), r.cdata(), s.cdata(), m.data(), num_data);
+    for (int i = 0; i < num_data; ++i)
+        Expect(near_equal(m[i], transform(t[i], r[i], s[i])));
+
+    t2.resize(num_data); r2.resize(num_data); s2.resize(num_data);
+    ExtractTRS(m.cdata(), t2.data(), r2.data(), s2.data(), num_data);
+    for (int i = 0; i < num_data; ++i) {
+        float3 et; quatf er; float3 es;
+        extract_trs(m[i], et, er, es);
+        Expect(near_equal(t2[i], et) && near_equal(s2[i], es));
+        Expect(near_equal(r2[i], er) || near_equal(r2[i], -er));
+        Expect(near_equal(t2[i], t[i]) && near_equal(s2[i], s[i], 1e-3f));
+    }
+
+#ifdef muSIMD_ExtractTRS
+    ExtractTRS_Generic(m.cdata(), t.data(), r.data(), s.data(), num_data);
+    ExtractTRS_ISPC(m.cdata(), t2.data(), r2.data(), s2.data(), num_data);
+    Expect(NearEqual(t.cdata(), t2.cdata(), num_data) && NearEqual(s.cdata(), s2.cdata(), num_data));
+    Expect(NearEqual((const float4*)r.cdata(), (const float4*)r2.cdata(), num_data));
+#endif
+}
+
 TestCase(Test_Angle)
 {
     auto q = mu::rotate_zxy(float3{ 15.0f, 30.0f, 45.0f });
@@ -138,6 +174,49 @@ TestCase(Test_Limits)
 }
 
 
+TestCase(Test_SharedVectorRelease)
+{
+    RawVector<int> src{ 1, 2, 3 };
+
+    // shared data can't be released
+    SharedVector<int> shared;
+    shared.share(src.cdata(), src.size());
+    Expect(shared.release() == nullptr);
+    Expect(shared.size() == 3 && shared.cdata() == src.cdata());
+
+    // owned buffer is handed over
+    SharedVector<int> owned{ 1, 2, 3 };
+    const int* data = owned.cdata();
+    int* released = owned.release();
+    Expect(released == data);
+    Expect(owned.empty() && owned.cdata() == nullptr);
+    Expect(released[0] == 1 && released[2] == 3);
+    SharedVector<int>::deallocate(released, sizeof(int) * 3);
+}
+
+TestCase(Test_WeldValues)
+{
+    RawVector<float2> uvs{ {0, 0}, {1, 0}, {0, 0}, {1, 1}, {1, 0}, {0, 0} };
+    RawVector<float2> values;
+    RawVector<int> indices;
+    size_t n = mu::WeldValues(values, indices, uvs.cdata(), uvs.size());
+    Expect(n == 3 && values.size() == 3);
+    Expect(indices.size() == 6 && indices[2] == 0 && indices[3] == 2 && indices[4] == 1);
+    for (size_t i = 0; i < uvs.size(); ++i)
+        Expect(values[indices[i]] == uvs[i]);
+
+    // two quads sharing an edge (vertices 1 and 2)
+    RawVector<int> vertex_indices{ 0, 1, 2, 3, 1, 4, 5, 2 };
+    RawVector<float3> smooth{ {0,1,0}, {0,1,0}, {1,0,0}, {0,1,0}, {0,1,0}, {0,0,1}, {0,0,1}, {1,0,0} };
+    RawVector<float3> per_vertex;
+    Expect(mu::ToPerVertex(per_vertex, smooth.cdata(), vertex_indices.cdata(), vertex_indices.size(), 6));
+    Expect((per_vertex.size() == 6 && per_vertex[2] == float3{ 1, 0, 0 } && per_vertex[5] == float3{ 0, 0, 1 }));
+
+    auto hard = smooth;
+    hard[4] = { 0, 0, 1 }; // vertex 1 has two different normals
+    Expect(!mu::ToPerVertex(per_vertex, hard.cdata(), vertex_indices.cdata(), vertex_indices.size(), 6));
+}
+
 TestCase(Test_Corruption)
 {
     if (muvgEnabled()) {
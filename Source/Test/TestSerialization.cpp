@@ -4,6 +4,7 @@
 #include "MeshUtils/MeshUtils.h"
 #include "SceneGraph/SceneGraph.h"
 #include "SceneGraph/sgSerializationImpl.h"
+#include "SceneGraph/sgContainer.h"
 
 using sg::serializer;
 using sg::deserializer;
@@ -156,3 +157,115 @@ TestCase(Test_Serialization)
         data.print();
     }
 }
+
+TestCase(Test_MappedStream)
+{
+    const char* path = "Test_MappedStream.bin";
+    {
+        sg::Scene scene;
+        auto root = scene.createNode<sg::RootNode>(nullptr, "");
+        auto mesh = scene.createNode<sg::MeshNode>(root, "mesh");
+        mesh->points.resize(1024);
+        for (int i = 0; i < 1024; ++i)
+            mesh->points[i] = { (float)i, (float)i * 2.0f, (float)i * 4.0f };
+
+        std::fstream f(path, std::ios::out | std::ios::binary);
+        sg::serializer s(f);
+        scene.serialize(s);
+    }
+
+    sg::Scene scene;
+    {
+        mu::MappedStream f(path);
+        Expect(f);
+        sg::deserializer d(f);
+        Expect(scene.deserialize(d));
+    }
+    // the stream is gone but the scene keeps the mapping alive
+    auto mesh = scene.getNodes<sg::MeshNode>();
+    Expect(mesh.size() == 1);
+    if (!mesh.empty()) {
+        auto& points = mesh[0]->points;
+        Expect(points.is_shared());
+        Expect((points.size() == 1024 && points[1023] == float3{ 1023.0f, 2046.0f, 4092.0f }));
+    }
+    scene.close();
+    std::remove(path);
+}
+
+TestCase(Test_SceneContainer)
+{
+    std::string buffer;
+    {
+        sg::Scene scene;
+        scene.frame_count = 10;
+        auto root = scene.createNode<sg::RootNode>(nullptr, "");
+        auto mat = scene.createNode<sg::MaterialNode>(root, "material");
+        mat->diffuse_color = { 1.0f, 0.5f, 0.25f };
+        auto skel = scene.createNode<sg::SkeletonNode>(root, "skel");
+        skel->addJoint("hip");
+        skel->addJoint("hip/spine");
+        auto mesh = scene.createNode<sg::MeshNode>(root, "mesh");
+        mesh->points.resize(256);
+        for (int i = 0; i < 256; ++i)
+            mesh->points[i] = { (float)i, 0.0f, 0.0f };
+        mesh->skeleton = skel;
+        mesh->joints = { skel->joints[1].get() };
+        mesh->materials = { mat };
+
+        std::stringstream ss;
+        Expect(sg::SceneContainer::write(ss, scene));
+        buffer = ss.str();
+
+        // payloads are serialized in parallel but the result must be deterministic
+        for (int i = 0; i < 4; ++i) {
+            std::stringstream ss2;
+            sg::SceneContainer::write(ss2, scene);
+            Expect(ss2.str() == buffer);
+        }
+    }
+
+    std::stringstream ss(buffer);
+    sg::Scene scene;
+    sg::SceneContainer container;
+    Expect(container.open(scene, ss));
+    Expect(scene.frame_count == 10 && scene.nodes.size() == 4 && scene.root_node);
+
+    // hierarchy is available before payloads are loaded
+    auto mesh = dynamic_cast<sg::MeshNode*>(scene.findNodeByPath("/mesh"));
+    auto skel = dynamic_cast<sg::SkeletonNode*>(scene.findNodeByPath("/skel"));
+    Expect(mesh && skel && mesh->parent == scene.root_node && skel->joints.size() == 2);
+    Expect(mesh && !container.isLoaded(mesh) && mesh->points.empty());
+
+    Expect(container.loadNode(mesh));
+    Expect(container.isLoaded(mesh) && mesh->points.size() == 256 && mesh->points[255].x == 255.0f);
+    Expect(mesh->skeleton == skel && mesh->joints.size() == 1 && mesh->joints[0] == skel->joints[1].get());
+    Expect(mesh->materials.size() == 1 && mesh->materials[0] == scene.findNodeByPath("/material"));
+
+    container.loadNodes();
+    auto mat = dynamic_cast<sg::MaterialNode*>(scene.findNodeByPath("/material"));
+    Expect((mat && mat->diffuse_color == float3{ 1.0f, 0.5f, 0.25f }));
+    Expect(skel->joints[1]->parent == skel->joints[0].get() && skel->joints[0]->skeleton == skel);
+
+    // load all payloads on open. stringstream is received section by section, file is mapped.
+    const char* path = "Test_SceneContainer.bin";
+    {
+        std::fstream f(path, std::ios::out | std::ios::binary);
+        f.write(buffer.data(), buffer.size());
+    }
+    for (int i = 0; i < 2; ++i) {
+        std::stringstream ss2(buffer);
+        sg::Scene scene2;
+        sg::SceneContainer container2;
+        Expect(i == 0 ? container2.open(scene2, ss2, true) : container2.open(scene2, path, true));
+        auto mesh2 = dynamic_cast<sg::MeshNode*>(scene2.findNodeByPath("/mesh"));
+        Expect(mesh2 && container2.isLoaded(mesh2) && mesh2->points.size() == 256 && mesh2->points.is_shared());
+    }
+    std::remove(path);
+
+    // truncated stream must fail
+    std::stringstream ss3(buffer.substr(0, buffer.size() - 4));
+    sg::Scene scene3;
+    sg::SceneContainer container3;
+    Expect(!container3.open(scene3, ss3, true));
+}
@@ -0,0 +1,57 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "SceneGraph/SceneGraph.h"
+#include "SceneGraph/SceneGraphRemote.h"
+
+TestCase(Test_USDLoadNestedPayload)
+{
+    // /A is loaded on open. /A/B is a payload under it.
+    const char* payload_path = "Test_USDLoadNestedPayload_payload.usda";
+    const char* root_path = "Test_USDLoadNestedPayload.usda";
+    {
+        std::fstream f(payload_path, std::ios::out);
+        f << "#usda 1.0\n"
+             "def Xform \"Inner\"\n"
+             "{\n"
+             "    def Mesh \"M\"\n"
+             "    {\n"
+             "        int[] faceVertexCounts = [3]\n"
+             "        int[] faceVertexIndices = [0, 1, 2]\n"
+             "        point3f[] points = [(0, 0, 0), (1, 0, 0), (0, 1, 0)]\n"
+             "    }\n"
+             "}\n";
+    }
+    {
+        std::fstream f(root_path, std::ios::out);
+        f << "#usda 1.0\n"
+             "def Xform \"A\"\n"
+             "{\n"
+             "    def Xform \"B\" (\n"
+             "        payload = @./Test_USDLoadNestedPayload_payload.usda@</Inner>\n"
+             "    )\n"
+             "    {\n"
+             "    }\n"
+             "}\n";
+    }
+
+    auto scene = sg::CreateUSDScene();
+    if (!scene) {
+        Print("    USD module is not available. skipped.\n");
+        return;
+    }
+    scene->open_options.load_payloads = false;
+    Expect(scene->open(root_path));
+    Expect(scene->findNodeByPath("/A") && !scene->findNodeByPath("/A/B/M"));
+
+    // loading an ancestor must construct payloads deeper than its direct children
+    Expect(scene->load("/"));
+    auto mesh = dynamic_cast<sg::MeshNode*>(scene->findNodeByPath("/A/B/M"));
+    Expect(mesh);
+    scene->read(0.0);
+    Expect(mesh && mesh->points.size() == 3);
+
+    scene->close();
+    std::remove(root_path);
+    std::remove(payload_path);
+}